@@ -0,0 +1,895 @@
+#define MIROIR_IMPLEMENTATION
+#define MIROIR_YAMLCPP_SPECIALIZATION
+#include <miroir/miroir.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include "miroir_bench_schema.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/// Allocations
+
+// heap usage of the process, tracked by the replaced global allocation functions
+static std::atomic<std::size_t> allocation_count{0};
+static std::atomic<std::size_t> allocated_bytes{0};
+static std::atomic<std::size_t> peak_allocated_bytes{0};
+
+// size of the allocation is stored before the returned pointer
+static constexpr std::size_t allocation_header_size = alignof(std::max_align_t);
+
+static auto allocate(std::size_t size) -> void * {
+    void *const ptr = std::malloc(size + allocation_header_size);
+
+    if (ptr == nullptr) {
+        return nullptr;
+    }
+
+    *static_cast<std::size_t *>(ptr) = size;
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    const std::size_t bytes = allocated_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak_bytes = peak_allocated_bytes.load(std::memory_order_relaxed);
+
+    while (bytes > peak_bytes &&
+           !peak_allocated_bytes.compare_exchange_weak(peak_bytes, bytes,
+                                                       std::memory_order_relaxed)) {
+    }
+
+    return static_cast<char *>(ptr) + allocation_header_size;
+}
+
+static void deallocate(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    void *const base = static_cast<char *>(ptr) - allocation_header_size;
+    allocated_bytes.fetch_sub(*static_cast<std::size_t *>(base), std::memory_order_relaxed);
+    std::free(base);
+}
+
+auto operator new(std::size_t size) -> void * {
+    if (void *const ptr = allocate(size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+auto operator new[](std::size_t size) -> void * { return operator new(size); }
+
+auto operator new(std::size_t size, const std::nothrow_t & /*tag*/) noexcept -> void * {
+    return allocate(size);
+}
+
+auto operator new[](std::size_t size, const std::nothrow_t & /*tag*/) noexcept -> void * {
+    return allocate(size);
+}
+
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::size_t /*size*/) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::size_t /*size*/) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, const std::nothrow_t & /*tag*/) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t & /*tag*/) noexcept { deallocate(ptr); }
+
+/// Suite
+
+struct Options {
+    std::string filter;   // runs only the workloads containing the substring
+    std::string json;     // path of the JSON report, none if empty
+    std::string baseline; // path of the JSON report to compare with, none if empty
+    int run_count;        // the best time of the runs is reported
+};
+
+// measurements of a single workload
+struct Result {
+    std::string name;
+    std::size_t doc_count;
+    std::size_t node_count; // nodes of all documents, keys are counted as well
+    double time;            // seconds per run
+    std::size_t allocation_count;
+    std::size_t peak_bytes; // peak heap usage on top of the usage before the run
+};
+
+class Suite {
+  public:
+    explicit Suite(Options options) : m_options{std::move(options)} {
+        if (!m_options.baseline.empty()) {
+            // JSON report is a valid YAML document
+            for (const YAML::Node &result : YAML::LoadFile(m_options.baseline)["benchmarks"]) {
+                m_baseline.emplace_back(result["name"].as<std::string>(),
+                                        result["ns_per_node"].as<double>());
+            }
+        }
+    }
+
+    auto is_selected(const std::string &name) const -> bool {
+        return name.find(m_options.filter) != std::string::npos;
+    }
+
+    // fn runs the workload once, doc_count and node_count are processed by a single run
+    template <typename Fn>
+    void run(const std::string &name, std::size_t doc_count, std::size_t node_count,
+             const Fn &fn) {
+
+        // the first run also warms up the caches
+        const std::size_t start_allocation_count = allocation_count.load();
+        const std::size_t start_bytes = allocated_bytes.load();
+        peak_allocated_bytes.store(start_bytes);
+
+        fn();
+
+        const std::size_t run_allocation_count = allocation_count.load() - start_allocation_count;
+        const std::size_t run_peak_bytes = peak_allocated_bytes.load() - start_bytes;
+
+        const Result result{
+            .name = name,
+            .doc_count = doc_count,
+            .node_count = node_count,
+            .time = measure(m_options.run_count, fn),
+            .allocation_count = run_allocation_count,
+            .peak_bytes = run_peak_bytes,
+        };
+
+        print(result);
+        m_results.push_back(result);
+    }
+
+    // writes the JSON report, returns false on failure
+    auto finish() const -> bool {
+        if (m_options.json.empty()) {
+            return true;
+        }
+
+        std::ofstream output{m_options.json};
+        output << "{\n  \"benchmarks\": [";
+
+        for (std::size_t i = 0; i < m_results.size(); ++i) {
+            const Result &result = m_results[i];
+            char line[512];
+
+            // names are made of identifiers, numbers and `/=-` only, so they aren't escaped
+            std::snprintf(line, sizeof(line),
+                          "%s\n    {\"name\": \"%s\", \"docs\": %zu, \"nodes\": %zu, "
+                          "\"time_ns\": %.0f, \"ns_per_node\": %.3f, "
+                          "\"allocations_per_doc\": %.3f, \"peak_bytes\": %zu}",
+                          i == 0 ? "" : ",", result.name.c_str(), result.doc_count,
+                          result.node_count, result.time * 1e9, ns_per_node(result),
+                          allocations_per_doc(result), result.peak_bytes);
+
+            output << line;
+        }
+
+        output << "\n  ]\n}\n";
+        return output.good();
+    }
+
+  private:
+    Options m_options;
+    std::vector<std::pair<std::string, double>> m_baseline; // name -> ns/node
+    std::vector<Result> m_results;
+
+    // returns the best time of few runs in seconds
+    template <typename Fn> static auto measure(int run_count, const Fn &fn) -> double {
+        double best_time = 0.0;
+
+        for (int i = 0; i < run_count; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+            best_time = i == 0 ? time.count() : std::min(best_time, time.count());
+        }
+
+        return best_time;
+    }
+
+    static auto ns_per_node(const Result &result) -> double {
+        return result.time * 1e9 / static_cast<double>(std::max<std::size_t>(result.node_count, 1));
+    }
+
+    static auto allocations_per_doc(const Result &result) -> double {
+        return static_cast<double>(result.allocation_count) /
+               static_cast<double>(std::max<std::size_t>(result.doc_count, 1));
+    }
+
+    void print(const Result &result) const {
+        std::printf("%-36s time=%10.3fms ns/node=%9.2f allocs/doc=%11.1f peak=%9.1fKiB",
+                    result.name.c_str(), result.time * 1e3, ns_per_node(result),
+                    allocations_per_doc(result), static_cast<double>(result.peak_bytes) / 1024.0);
+
+        const auto baseline_it = std::find_if(
+            m_baseline.begin(), m_baseline.end(),
+            [&](const auto &baseline) -> bool { return baseline.first == result.name; });
+
+        if (baseline_it != m_baseline.end() && baseline_it->second > 0.0) {
+            const double change = ns_per_node(result) / baseline_it->second - 1.0;
+            std::printf(" vs baseline=%+.1f%%", change * 100.0);
+        }
+
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+};
+
+/// Misc
+
+static auto count_nodes(const YAML::Node &node) -> std::size_t {
+    std::size_t count = 1;
+
+    if (node.IsSequence()) {
+        for (const YAML::Node &child : node) {
+            count += count_nodes(child);
+        }
+    } else if (node.IsMap()) {
+        for (const auto &child : node) {
+            count += count_nodes(child.first) + count_nodes(child.second);
+        }
+    }
+
+    return count;
+}
+
+static auto count_nodes(const std::vector<YAML::Node> &docs) -> std::size_t {
+    std::size_t count = 0;
+
+    for (const YAML::Node &doc : docs) {
+        count += count_nodes(doc);
+    }
+
+    return count;
+}
+
+/// Batch validation
+
+static const char *const batch_schema = R"(
+types:
+  map<K;V>: { $K: V }
+  endpoint:
+    host: string
+    port: integer
+    tls: !optional boolean
+root:
+  name: string
+  version: integer
+  endpoints: [endpoint]
+  labels: !optional map<string;string>
+)";
+
+static auto make_batch_docs(std::size_t count) -> std::vector<YAML::Node> {
+    std::vector<YAML::Node> docs;
+    docs.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string n = std::to_string(i);
+
+        docs.push_back(YAML::Load("name: service" + n + "\n"
+                                  "version: " + n + "\n"
+                                  "endpoints:\n"
+                                  "  - { host: host" + n + ".local, port: 8080, tls: true }\n"
+                                  "  - { host: host" + n + ".internal, port: 9090 }\n"
+                                  "labels: { team: core, tier: backend, zone: z" + n + " }\n"));
+    }
+
+    return docs;
+}
+
+static void bench_batch_scaling(Suite &suite) {
+    const std::size_t max_thread_count = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> thread_counts;
+
+    for (std::size_t thread_count = 1; thread_count < max_thread_count; thread_count *= 2) {
+        thread_counts.push_back(thread_count);
+    }
+
+    thread_counts.push_back(max_thread_count);
+
+    std::optional<miroir::Validator<YAML::Node>> validator;
+    std::vector<YAML::Node> docs;
+
+    for (const std::size_t thread_count : thread_counts) {
+        const std::string name = "batch/threads=" + std::to_string(thread_count);
+
+        if (!suite.is_selected(name)) {
+            continue;
+        }
+
+        if (!validator.has_value()) {
+            validator.emplace(YAML::Load(batch_schema));
+            docs = make_batch_docs(20000);
+        }
+
+        miroir::ThreadPool thread_pool{thread_count};
+
+        suite.run(name, docs.size(), count_nodes(docs), [&]() -> void {
+            const auto errors = validator->validate_batch(docs, {.executor = &thread_pool});
+            if (errors.size() != docs.size()) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Wide maps
+
+static void bench_wide_map(Suite &suite) {
+    const miroir::Validator<YAML::Node> validator{YAML::Load(R"(
+    root:
+      name: string
+      version: integer
+      $string: integer
+    )")};
+
+    for (std::size_t key_count = 1000; key_count <= 64000; key_count *= 4) {
+        const std::string name = "wide_map/keys=" + std::to_string(key_count);
+
+        if (!suite.is_selected(name)) {
+            continue;
+        }
+
+        std::string doc_str = "name: wide\nversion: 1\n";
+        for (std::size_t i = 0; i < key_count; ++i) {
+            doc_str += "key" + std::to_string(i) + ": " + std::to_string(i) + "\n";
+        }
+
+        const YAML::Node doc = YAML::Load(doc_str);
+
+        suite.run(name, 1, count_nodes(doc), [&]() -> void {
+            if (!validator.validate(doc).empty()) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Scalar lists
+
+static void bench_scalar_lists(Suite &suite) {
+    const std::size_t item_count = 200000;
+
+    for (const std::string type : {"integer", "numeric", "boolean", "string"}) {
+        const std::string name = "scalar_list/type=" + type;
+
+        if (!suite.is_selected(name)) {
+            continue;
+        }
+
+        const miroir::Validator<YAML::Node> validator{YAML::Load("root: [" + type + "]")};
+
+        YAML::Node doc{YAML::NodeType::Sequence};
+        for (std::size_t i = 0; i < item_count; ++i) {
+            if (type == "integer") {
+                doc.push_back(std::to_string(i));
+            } else if (type == "numeric") {
+                doc.push_back(std::to_string(i) + ".5e-3");
+            } else if (type == "boolean") {
+                doc.push_back(i % 2 == 0 ? "true" : "off");
+            } else {
+                doc.push_back("value" + std::to_string(i));
+            }
+        }
+
+        suite.run(name, 1, count_nodes(doc), [&]() -> void {
+            if (!validator.is_valid(doc)) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Generics
+
+// pair<A;B> nested `depth` times, the document is a full binary tree of integers
+static auto generic_schema(std::size_t depth) -> std::string {
+    std::string type = "integer";
+    for (std::size_t i = 0; i < depth; ++i) {
+        type = "pair<" + type + ";" + type + ">";
+    }
+
+    return "types:\n  pair<A;B>: { first: A, second: B }\nroot: [" + type + "]\n";
+}
+
+static auto generic_value(std::size_t depth) -> std::string {
+    if (depth == 0) {
+        return "1";
+    }
+
+    const std::string child = generic_value(depth - 1);
+    return "{ first: " + child + ", second: " + child + " }";
+}
+
+static void bench_generics(Suite &suite) {
+    const std::size_t item_count = 200;
+
+    for (std::size_t depth = 2; depth <= 8; depth += 3) {
+        const YAML::Node schema = YAML::Load(generic_schema(depth));
+        const std::string compile_name = "generic_compile/depth=" + std::to_string(depth);
+
+        if (suite.is_selected(compile_name)) {
+            suite.run(compile_name, 1, count_nodes(schema), [&]() -> void {
+                const miroir::Validator<YAML::Node> validator{schema};
+            });
+        }
+
+        const std::string name = "generic/depth=" + std::to_string(depth);
+
+        if (!suite.is_selected(name)) {
+            continue;
+        }
+
+        const miroir::Validator<YAML::Node> validator{schema};
+
+        YAML::Node doc{YAML::NodeType::Sequence};
+        const YAML::Node item = YAML::Load(generic_value(depth));
+        for (std::size_t i = 0; i < item_count; ++i) {
+            doc.push_back(YAML::Clone(item));
+        }
+
+        suite.run(name, 1, count_nodes(doc), [&]() -> void {
+            if (!validator.validate(doc).empty()) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Value variants
+
+static void bench_value_variant(Suite &suite) {
+    const std::size_t item_count = 20000;
+
+    for (std::size_t value_count = 10; value_count <= 10000; value_count *= 10) {
+        const std::string name = "value_variant/values=" + std::to_string(value_count);
+
+        if (!suite.is_selected(name)) {
+            continue;
+        }
+
+        std::string schema_str = "root: [code]\ntypes:\n  code: !variant [ code0";
+        for (std::size_t i = 1; i < value_count; ++i) {
+            schema_str += ", code" + std::to_string(i);
+        }
+        schema_str += " ]\n";
+
+        const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+
+        YAML::Node doc{YAML::NodeType::Sequence};
+        for (std::size_t i = 0; i < item_count; ++i) {
+            doc.push_back("code" + std::to_string(i * 7919 % value_count));
+        }
+
+        suite.run(name, 1, count_nodes(doc), [&]() -> void {
+            if (!validator.is_valid(doc)) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Type variants
+
+static void bench_type_variant(Suite &suite) {
+    const std::size_t variant_count = 20;
+    const std::size_t item_count = 20000;
+    const std::string name = "type_variant/variants=" + std::to_string(variant_count);
+
+    if (!suite.is_selected(name)) {
+        return;
+    }
+
+    std::string schema_str = "root: [shape]\ntypes:\n  shape: [ kind0";
+    for (std::size_t i = 1; i < variant_count; ++i) {
+        schema_str += ", kind" + std::to_string(i);
+    }
+    schema_str += " ]\n";
+
+    for (std::size_t i = 0; i < variant_count; ++i) {
+        const std::string n = std::to_string(i);
+        schema_str += "  kind" + n + ": { kind: !variant [kind" + n +
+                      "], name: string, size: integer, tags: !optional [string] }\n";
+    }
+
+    const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+
+    YAML::Node doc{YAML::NodeType::Sequence};
+    for (std::size_t i = 0; i < item_count; ++i) {
+        const std::string n = std::to_string(i);
+        doc.push_back(YAML::Load("{ kind: kind" + std::to_string(i % variant_count) +
+                                 ", name: item" + n + ", size: " + n + ", tags: [a, b] }"));
+    }
+
+    suite.run(name, 1, count_nodes(doc), [&]() -> void {
+        if (!validator.is_valid(doc)) {
+            std::abort();
+        }
+    });
+}
+
+/// Embedded types
+
+static void bench_embed_chain(Suite &suite) {
+    const std::size_t item_count = 2000;
+
+    for (std::size_t depth = 2; depth <= 32; depth *= 4) {
+        const std::string name = "embed_chain/depth=" + std::to_string(depth);
+
+        if (!suite.is_selected(name)) {
+            continue;
+        }
+
+        // each level embeds the next one, so the root type has a field of every level
+        std::string schema_str = "root: [level0]\ntypes:\n";
+        std::string item_str = "{ ";
+
+        for (std::size_t i = 0; i < depth; ++i) {
+            const std::string n = std::to_string(i);
+            schema_str += "  level" + n + ": { field" + n + ": integer";
+            if (i + 1 < depth) {
+                schema_str += ", _: !embed level" + std::to_string(i + 1);
+            }
+            schema_str += " }\n";
+            item_str += (i == 0 ? "field" : ", field") + n + ": " + n;
+        }
+
+        item_str += " }";
+
+        const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+
+        YAML::Node doc{YAML::NodeType::Sequence};
+        for (std::size_t i = 0; i < item_count; ++i) {
+            doc.push_back(YAML::Load(item_str));
+        }
+
+        suite.run(name, 1, count_nodes(doc), [&]() -> void {
+            if (!validator.validate(doc).empty()) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Key attributes
+
+static void bench_ignore_attributes(Suite &suite) {
+    const std::size_t field_count = 20;
+    const std::size_t item_count = 5000;
+    const std::string name = "ignore_attributes/fields=" + std::to_string(field_count);
+
+    if (!suite.is_selected(name)) {
+        return;
+    }
+
+    // every key has an attribute, so the fields are found by the trimmed keys only
+    std::string schema_str = "settings: { ignore_attributes: true }\nroot: [record]\n"
+                             "types:\n  record: { $string: string";
+    std::string item_str = "{ ";
+
+    for (std::size_t i = 0; i < field_count; ++i) {
+        const std::string n = std::to_string(i);
+        schema_str += ", field" + n + ": integer";
+        item_str += (i == 0 ? "field" : ", field") + n + ":attr" + n + ": " + n;
+    }
+
+    schema_str += " }\n";
+    item_str += ", extra: value }";
+
+    const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+
+    YAML::Node doc{YAML::NodeType::Sequence};
+    for (std::size_t i = 0; i < item_count; ++i) {
+        doc.push_back(YAML::Load(item_str));
+    }
+
+    suite.run(name, 1, count_nodes(doc), [&]() -> void {
+        if (!validator.validate(doc).empty()) {
+            std::abort();
+        }
+    });
+}
+
+/// Flat document
+
+static void bench_flat_document(Suite &suite) {
+    const std::string schema_str = R"(
+types:
+  map<K;V>: { $K: V }
+  endpoint:
+    host: string
+    port: integer
+    tls: !optional boolean
+  record:
+    name: string
+    version: integer
+    endpoints: [endpoint]
+    labels: !optional map<string;string>
+root: [record]
+)";
+    const std::size_t record_count = 20000;
+    const std::string name = "document/node=yaml-cpp";
+    const std::string flat_name = "document/node=flat";
+
+    if (!suite.is_selected(name) && !suite.is_selected(flat_name)) {
+        return;
+    }
+
+    std::string doc_str;
+    for (std::size_t i = 0; i < record_count; ++i) {
+        const std::string n = std::to_string(i);
+        doc_str += "- { name: service" + n + ", version: " + n +
+                   ", endpoints: [ { host: host" + n + ".local, port: 8080, tls: true } ]" +
+                   ", labels: { team: core, zone: z" + n + " } }\n";
+    }
+
+    const YAML::Node doc = YAML::Load(doc_str);
+    const std::size_t node_count = count_nodes(doc);
+
+    if (suite.is_selected(name)) {
+        const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+
+        suite.run(name, 1, node_count, [&]() -> void {
+            if (!validator.validate(doc).empty()) {
+                std::abort();
+            }
+        });
+    }
+
+    if (suite.is_selected(flat_name)) {
+        const miroir::FlatDocument flat_schema{schema_str};
+        const miroir::Validator<miroir::FlatNode> flat_validator{flat_schema.root()};
+        const miroir::FlatDocument flat_doc{doc_str};
+
+        suite.run(flat_name, 1, node_count, [&]() -> void {
+            if (!flat_validator.validate(flat_doc.root()).empty()) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Generated validators
+
+static void bench_codegen(Suite &suite) {
+    using Generated = bench_schema::Validator<YAML::Node>;
+    using FlatGenerated = bench_schema::Validator<miroir::FlatNode>;
+
+    const std::size_t record_count = 20000;
+    const std::string name = "codegen/validator=interpreted";
+    const std::string generated_name = "codegen/validator=generated";
+    const std::string flat_name = "codegen_flat/validator=interpreted";
+    const std::string flat_generated_name = "codegen_flat/validator=generated";
+
+    if (!suite.is_selected(name) && !suite.is_selected(generated_name) &&
+        !suite.is_selected(flat_name) && !suite.is_selected(flat_generated_name)) {
+        return;
+    }
+
+    std::string doc_str;
+    for (std::size_t i = 0; i < record_count; ++i) {
+        const std::string n = std::to_string(i);
+        doc_str += "- { name: service" + n + ", version: " + n +
+                   ", endpoints: [ { host: host" + n + ".local, port: 8080, tls: true } ]" +
+                   ", checks: [ { kind: tcp, timeout: 5 }, { kind: http, path: /health } ]" +
+                   ", labels: { team: core, zone: z" + n + " } }\n";
+    }
+
+    const std::string schema_str{Generated::schema};
+    const YAML::Node doc = YAML::Load(doc_str);
+    const std::size_t node_count = count_nodes(doc);
+
+    if (suite.is_selected(name)) {
+        const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+
+        suite.run(name, 1, node_count, [&]() -> void {
+            if (!validator.validate(doc).empty()) {
+                std::abort();
+            }
+        });
+    }
+
+    if (suite.is_selected(generated_name)) {
+        suite.run(generated_name, 1, node_count, [&]() -> void {
+            if (!Generated::validate(doc).empty()) {
+                std::abort();
+            }
+        });
+    }
+
+    const miroir::FlatDocument flat_doc{doc_str};
+
+    if (suite.is_selected(flat_name)) {
+        const miroir::FlatDocument flat_schema{schema_str};
+        const miroir::Validator<miroir::FlatNode> flat_validator{flat_schema.root()};
+
+        suite.run(flat_name, 1, node_count, [&]() -> void {
+            if (!flat_validator.validate(flat_doc.root()).empty()) {
+                std::abort();
+            }
+        });
+    }
+
+    if (suite.is_selected(flat_generated_name)) {
+        suite.run(flat_generated_name, 1, node_count, [&]() -> void {
+            if (!FlatGenerated::validate(flat_doc.root()).empty()) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Binary schema
+
+static void bench_schema_load(Suite &suite) {
+    const std::size_t type_count = 500;
+    const std::string name = "schema_load/format=yaml";
+    const std::string binary_name = "schema_load/format=binary";
+
+    if (!suite.is_selected(name) && !suite.is_selected(binary_name)) {
+        return;
+    }
+
+    // large schema of a config file with many sections
+    std::string schema_str = "types:\n  map<K;V>: { $K: V }\n";
+    std::string root_str = "root:\n";
+
+    for (std::size_t i = 0; i < type_count; ++i) {
+        const std::string n = std::to_string(i);
+        schema_str += "  section" + n + ":\n    name: string\n    port: !optional integer\n" +
+                      "    mode: !variant [fast, slow, off]\n" +
+                      "    labels: !optional map<string;string>\n" +
+                      "    items: !optional [[string, { id: integer, tags: [string] }]]\n";
+        root_str += "  section" + n + ": !optional section" + n + "\n";
+    }
+
+    schema_str += root_str;
+
+    const std::string blob = miroir::Validator<YAML::Node>{YAML::Load(schema_str)}.serialize();
+    const std::size_t node_count = count_nodes(YAML::Load(schema_str));
+
+    // the schema is loaded from the file content
+    if (suite.is_selected(name)) {
+        suite.run(name, 1, node_count, [&]() -> void {
+            const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+        });
+    }
+
+    if (suite.is_selected(binary_name)) {
+        suite.run(binary_name, 1, node_count, [&]() -> void {
+            if (!miroir::Validator<YAML::Node>::deserialize(blob).has_value()) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Revalidation
+
+static void bench_revalidate(Suite &suite) {
+    const std::string schema_str = R"(
+types:
+  map<K;V>: { $K: V }
+  record:
+    name: string
+    version: integer
+    labels: !optional map<string;string>
+root: { $string: map<string;record> }
+)";
+    const std::size_t group_count = 100;
+    const std::size_t record_count = 200;
+    const std::string name = "edit/validation=full";
+    const std::string incremental_name = "edit/validation=incremental";
+
+    if (!suite.is_selected(name) && !suite.is_selected(incremental_name)) {
+        return;
+    }
+
+    // large config with few groups of records, one of which is patched
+    std::string doc_str;
+    for (std::size_t i = 0; i < group_count; ++i) {
+        doc_str += "group" + std::to_string(i) + ":\n";
+
+        for (std::size_t j = 0; j < record_count; ++j) {
+            const std::string n = std::to_string(j);
+            doc_str += "  service" + n + ": { name: service" + n + ", version: " + n +
+                       ", labels: { team: core, zone: z" + n + " } }\n";
+        }
+    }
+
+    const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+    YAML::Node doc = YAML::Load(doc_str);
+    const std::size_t node_count = count_nodes(doc);
+    const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+
+    doc["group42"]["service7"]["version"] = "latest";
+    const std::vector<std::string> changed_paths = {"/group42.service7.version"};
+
+    if (suite.is_selected(name)) {
+        suite.run(name, 1, node_count, [&]() -> void {
+            if (validator.validate(doc).size() != 1) {
+                std::abort();
+            }
+        });
+    }
+
+    if (suite.is_selected(incremental_name)) {
+        suite.run(incremental_name, 1, node_count, [&]() -> void {
+            if (validator.revalidate(doc, errors, changed_paths).size() != 1) {
+                std::abort();
+            }
+        });
+    }
+}
+
+/// Main
+
+static auto parse_options(int argc, char **argv) -> std::optional<Options> {
+    Options options{
+        .filter = "",
+        .json = "",
+        .baseline = "",
+        .run_count = 5,
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const std::string_view value = arg.substr(std::min(arg.find('=') + 1, arg.size()));
+
+        if (arg.starts_with("--filter=")) {
+            options.filter = value;
+        } else if (arg.starts_with("--json=")) {
+            options.json = value;
+        } else if (arg.starts_with("--baseline=")) {
+            options.baseline = value;
+        } else if (arg.starts_with("--runs=") && std::atoi(value.data()) > 0) {
+            options.run_count = std::atoi(value.data());
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    return options;
+}
+
+auto main(int argc, char **argv) -> int {
+    const std::optional<Options> options = parse_options(argc, argv);
+
+    if (!options.has_value()) {
+        std::fprintf(stderr, "usage: %s [--filter=<substring>] [--runs=<count>] "
+                             "[--json=<report.json>] [--baseline=<report.json>]\n",
+                     argv[0]);
+        return 1;
+    }
+
+    Suite suite{*options};
+
+    bench_batch_scaling(suite);
+    bench_wide_map(suite);
+    bench_scalar_lists(suite);
+    bench_generics(suite);
+    bench_value_variant(suite);
+    bench_type_variant(suite);
+    bench_embed_chain(suite);
+    bench_ignore_attributes(suite);
+    bench_flat_document(suite);
+    bench_codegen(suite);
+    bench_schema_load(suite);
+    bench_revalidate(suite);
+
+    if (!suite.finish()) {
+        std::fprintf(stderr, "failed to write %s\n", options->json.c_str());
+        return 1;
+    }
+
+    return 0;
+}
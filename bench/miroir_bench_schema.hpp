@@ -0,0 +1,714 @@
+// clang-format off
+// generated by miroir_codegen from bench/miroir_bench_schema.yml, do not edit
+// note: must be included after <miroir/miroir.hpp> in the translation unit defining
+// MIROIR_IMPLEMENTATION
+
+#pragma once
+
+#ifndef MIROIR_IMPLEMENTATION
+#error "generated validator needs the miroir implementation"
+#endif
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bench_schema {
+
+// Custom provides the custom types as static functions, e.g.
+// `static auto even(const Node &node) -> bool`
+template <typename Node, typename Custom = void> class Validator {
+  public:
+    using Error = miroir::Error<Node>;
+
+  private:
+    using Runtime = miroir::GeneratedRuntime<Node>;
+    using NodeAccessor = typename Runtime::NodeAccessor;
+    using Expected = typename Runtime::Expected;
+    using Context = typename Runtime::Context;
+    using EmbedClaims = typename Runtime::EmbedClaims;
+    using MapChild = typename Runtime::MapChild;
+    using Field = typename Runtime::Field;
+    using ErrorType = miroir::ErrorType;
+
+  public:
+    // schema the validator is generated from
+    static constexpr std::string_view schema = R"miroir(# schema of the generated validator benchmark, regenerate with `make codegen`
+types:
+  map<K;V>: { $K: V }
+  endpoint:
+    host: string
+    port: integer
+    tls: !optional boolean
+  check:
+    - { kind: !variant [http], path: string }
+    - { kind: !variant [tcp], timeout: integer }
+  record:
+    name: string
+    version: integer
+    endpoints: [endpoint]
+    checks: !optional [check]
+    labels: !optional map<string;string>
+root: [record]
+)miroir";
+
+    // same as miroir::Validator::validate with ValidationOptions::max_error_count only
+    static auto validate(const Node &doc, std::size_t max_error_count = 0) -> std::vector<Error> {
+        static const Expected expected = Expected{std::string{"[record]"}};
+        return Runtime::validate(doc, max_error_count, expected, &node_22);
+    }
+
+    // same as validate(doc).empty(), but doesn't build errors and stops on the first one
+    static auto is_valid(const Node &doc) -> bool {
+        static const Expected expected = Expected{std::string{"[record]"}};
+        return Runtime::is_valid(doc, expected, &node_22);
+    }
+
+  private:
+    static void node_0(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"string"}};
+
+        if (!miroir::impl::node_is_string(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_1(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"integer"}};
+
+        if (!miroir::impl::node_is_integer(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_2(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"string"}};
+
+        if (!miroir::impl::node_is_string(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_3(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"integer"}};
+
+        if (!miroir::impl::node_is_integer(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_4(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"boolean"}};
+
+        if (!miroir::impl::node_is_boolean(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_5(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const std::string key_0{"host"};
+        static const std::string key_1{"port"};
+        static const std::string key_2{"tls"};
+        static constexpr std::array<Field, 3> fields{{{"host", 0}, {"port", 1}, {"tls", 2}}};
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_0), errors);
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_1), errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+        std::array<std::size_t, 3> field_children;
+        Runtime::find_fields(children, fields, '\0', field_children);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_0);
+
+            if (field_children[0] != Runtime::npos) {
+                MapChild &child = children[field_children[0]];
+                node_2(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_1);
+
+            if (field_children[1] != Runtime::npos) {
+                MapChild &child = children[field_children[1]];
+                node_3(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_2);
+
+            if (field_children[2] != Runtime::npos) {
+                MapChild &child = children[field_children[2]];
+                node_4(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    static void node_6(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"endpoint"}};
+        node_5(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_7(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        const std::size_t size = NodeAccessor::size(doc);
+
+        for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {
+            node_6(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);
+        }
+    }
+
+    static constexpr std::array<std::string_view, 1> scalars_8{"http"};
+    static constexpr std::array<std::string_view, 0> dumps_8{};
+
+    static void node_8(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!Runtime::values_contain(doc, scalars_8, dumps_8)) {
+            Runtime::add_error(ErrorType::InvalidValue, ctx, errors);
+        }
+    }
+
+    static void node_9(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"string"}};
+
+        if (!miroir::impl::node_is_string(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_10(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const std::string key_0{"kind"};
+        static const std::string key_1{"path"};
+        static constexpr std::array<Field, 2> fields{{{"kind", 0}, {"path", 1}}};
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_0), errors);
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_1), errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+        std::array<std::size_t, 2> field_children;
+        Runtime::find_fields(children, fields, '\0', field_children);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_0);
+
+            if (field_children[0] != Runtime::npos) {
+                MapChild &child = children[field_children[0]];
+                node_8(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_1);
+
+            if (field_children[1] != Runtime::npos) {
+                MapChild &child = children[field_children[1]];
+                node_9(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    static constexpr std::array<std::string_view, 1> scalars_11{"tcp"};
+    static constexpr std::array<std::string_view, 0> dumps_11{};
+
+    static void node_11(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!Runtime::values_contain(doc, scalars_11, dumps_11)) {
+            Runtime::add_error(ErrorType::InvalidValue, ctx, errors);
+        }
+    }
+
+    static void node_12(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"integer"}};
+
+        if (!miroir::impl::node_is_integer(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_13(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const std::string key_0{"kind"};
+        static const std::string key_1{"timeout"};
+        static constexpr std::array<Field, 2> fields{{{"kind", 0}, {"timeout", 1}}};
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_0), errors);
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_1), errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+        std::array<std::size_t, 2> field_children;
+        Runtime::find_fields(children, fields, '\0', field_children);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_0);
+
+            if (field_children[0] != Runtime::npos) {
+                MapChild &child = children[field_children[0]];
+                node_11(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_1);
+
+            if (field_children[1] != Runtime::npos) {
+                MapChild &child = children[field_children[1]];
+                node_12(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    // returns false if the node can't match the schema node
+    static auto shape_10(const Node &doc) -> bool {
+        if (!NodeAccessor::is_map(doc)) {
+            return false;
+        }
+
+        const std::optional<Node> value_0 = Runtime::find_value(doc, "kind", '\0');
+
+        if (!value_0.has_value() || !Runtime::values_contain(*value_0, scalars_8, dumps_8)) {
+            return false;
+        }
+
+        const std::optional<Node> value_1 = Runtime::find_value(doc, "path", '\0');
+
+        if (!value_1.has_value()) {
+            return false;
+        }
+
+        return true;
+    }
+
+    // returns false if the node can't match the schema node
+    static auto shape_13(const Node &doc) -> bool {
+        if (!NodeAccessor::is_map(doc)) {
+            return false;
+        }
+
+        const std::optional<Node> value_0 = Runtime::find_value(doc, "kind", '\0');
+
+        if (!value_0.has_value() || !Runtime::values_contain(*value_0, scalars_11, dumps_11)) {
+            return false;
+        }
+
+        const std::optional<Node> value_1 = Runtime::find_value(doc, "timeout", '\0');
+
+        if (!value_1.has_value()) {
+            return false;
+        }
+
+        return true;
+    }
+
+    static void node_14(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        std::vector<std::vector<Error>> grouped_errors(2);
+        bool has_skipped_variants = false;
+
+        static const Expected expected_0 = Expected{std::string{"{kind: !<!variant> [http], path: string}"}};
+
+        if (!shape_10(doc)) {
+            has_skipped_variants = true;
+        } else if (Runtime::validate_variant(doc, ctx, expected_0, &node_10, grouped_errors[0])) {
+            return;
+        }
+
+        static const Expected expected_1 = Expected{std::string{"{kind: !<!variant> [tcp], timeout: integer}"}};
+
+        if (!shape_13(doc)) {
+            has_skipped_variants = true;
+        } else if (Runtime::validate_variant(doc, ctx, expected_1, &node_13, grouped_errors[1])) {
+            return;
+        }
+
+        if (has_skipped_variants && !ctx.is_check_only) {
+            if (!shape_10(doc)) {
+                Runtime::validate_variant(doc, ctx, expected_0, &node_10, grouped_errors[0]);
+            }
+            if (!shape_13(doc)) {
+                Runtime::validate_variant(doc, ctx, expected_1, &node_13, grouped_errors[1]);
+            }
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        Runtime::add_error(ErrorType::InvalidValueType, ctx, errors, std::move(grouped_errors));
+    }
+
+    static void node_15(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"check"}};
+        node_14(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_16(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        const std::size_t size = NodeAccessor::size(doc);
+
+        for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {
+            node_15(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);
+        }
+    }
+
+    static void node_17(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"string"}};
+
+        if (!miroir::impl::node_is_string(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_18(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            for (MapChild &child : children) {
+                if (child.is_validated) {
+                    continue;
+                }
+
+                if (miroir::impl::node_is_string(child.key)) {
+                    child.key_type = 0;
+                }
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            bool key_type_is_found = false;
+
+            for (std::size_t j = 0; j < children.size() && !ctx.is_stopped(); ++j) {
+                MapChild &child = children[j];
+
+                if (child.key_type == 0) {
+                    node_17(child.value, ctx.appending_key(child.key), errors);
+                    child.is_validated = true;
+                    key_type_is_found = true;
+                }
+            }
+
+            static const Expected key_type_expected = Expected{std::string{"K"}};
+
+            if (!key_type_is_found) {
+                Runtime::add_error(ErrorType::MissingKeyWithType, ctx.with_expected(key_type_expected), errors);
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    static void node_19(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"map<string;string>"}};
+        node_18(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_20(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const std::string key_0{"name"};
+        static const std::string key_1{"version"};
+        static const std::string key_2{"endpoints"};
+        static const std::string key_3{"checks"};
+        static const std::string key_4{"labels"};
+        static constexpr std::array<Field, 5> fields{{{"checks", 3}, {"endpoints", 2}, {"labels", 4}, {"name", 0}, {"version", 1}}};
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_0), errors);
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_1), errors);
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_2), errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+        std::array<std::size_t, 5> field_children;
+        Runtime::find_fields(children, fields, '\0', field_children);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_0);
+
+            if (field_children[0] != Runtime::npos) {
+                MapChild &child = children[field_children[0]];
+                node_0(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_1);
+
+            if (field_children[1] != Runtime::npos) {
+                MapChild &child = children[field_children[1]];
+                node_1(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_2);
+
+            if (field_children[2] != Runtime::npos) {
+                MapChild &child = children[field_children[2]];
+                node_7(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_3);
+
+            if (field_children[3] != Runtime::npos) {
+                MapChild &child = children[field_children[3]];
+                node_16(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_4);
+
+            if (field_children[4] != Runtime::npos) {
+                MapChild &child = children[field_children[4]];
+                node_19(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    static void node_21(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"record"}};
+        node_20(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_22(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        const std::size_t size = NodeAccessor::size(doc);
+
+        for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {
+            node_21(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);
+        }
+    }
+
+};
+
+} // namespace bench_schema
@@ -1,10 +1,23 @@
 #ifndef MIROIR_MIROIR_HPP
 #define MIROIR_MIROIR_HPP
 
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -35,6 +48,8 @@ template <typename Node> struct NodeAccessor {
     template <typename T> static auto as(const Node &node) -> T;
     // casts node to type T or returns a fallback value of the same type
     template <typename T> static auto as(const Node &node, const T &fallback) -> T;
+    // optional, returns content of the scalar node without copying, valid while the node exists
+    static auto scalar_view(const Node &node) -> std::string_view;
 
     // returns tag of the node
     static auto tag(const Node &node) -> std::string;
@@ -45,6 +60,11 @@ template <typename Node> struct NodeAccessor {
     static auto equals(const Node &lhs, const Node &rhs) -> bool;
     // returns true if both nodes point to the same memory
     static auto is_same(const Node &lhs, const Node &rhs) -> bool;
+    // optional, returns address of the node data, equal for the same nodes, enables memoization
+    static auto identity(const Node &node) -> const void *;
+    // optional, returns hash of the node content, equal for equal nodes, enables hashed lookup of
+    // the `!variant` values
+    static auto hash(const Node &node) -> std::size_t;
 
     // returns number of children for map and sequence nodes
     static auto size(const Node &node) -> std::size_t;
@@ -75,6 +95,86 @@ template <typename Node> struct Error {
     auto description(int max_depth = 0) const -> std::string;
 };
 
+// runs validation tasks in parallel
+class Executor {
+  public:
+    virtual ~Executor() = default;
+
+    // returns number of tasks that can run simultaneously
+    virtual auto concurrency() const -> std::size_t = 0;
+    // calls task(i) for each i in [0, count) and blocks until all calls are finished
+    // note: called recursively from the tasks when nested nodes are validated in parallel
+    virtual void run(std::size_t count, const std::function<void(std::size_t)> &task) = 0;
+};
+
+// fixed size thread pool, the calling thread also runs the tasks while waiting for them
+class ThreadPool final : public Executor {
+  public:
+    // std::size_t thread_count - number of threads including the calling one
+    explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency());
+    ~ThreadPool() override;
+
+    ThreadPool(const ThreadPool &) = delete;
+    auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+
+    auto concurrency() const -> std::size_t override;
+    void run(std::size_t count, const std::function<void(std::size_t)> &task) override;
+
+  private:
+    struct Job;
+
+    void work();
+    static void execute(Job &job);
+
+  private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::shared_ptr<Job>> m_jobs;
+    std::vector<std::thread> m_threads;
+    bool m_is_stopped;
+};
+
+// counters of the validation, collected if ValidationOptions::stats is set
+struct ValidationStats {
+    struct TypeStats {
+        std::size_t dispatch_count = 0;   // nodes validated against the type, including map keys
+        std::chrono::nanoseconds time{0}; // total time of the dispatches, including nested types
+    };
+
+    // document nodes validated against the schema nodes, a node is counted once for each schema
+    // node it's validated against (e.g. for each alternative of a type variant)
+    std::size_t node_count = 0;
+    std::size_t variant_attempt_count = 0; // alternatives of the type variants validated
+    std::size_t variant_reject_count = 0;  // validated alternatives which didn't match the node
+    std::size_t variant_skip_count = 0;    // alternatives skipped because of the node shape
+    std::size_t key_probe_count = 0;       // checks of the map keys against the `$key` types
+    std::map<std::string, TypeStats, std::less<>> types; // type name -> counters
+
+    // adds the counters of other stats, e.g. collected by another thread
+    void merge(const ValidationStats &other);
+};
+
+struct ValidationOptions {
+    // validates large sequences and maps in parallel if set, errors order is the same as for the
+    // sequential validation
+    Executor *executor = nullptr;
+    // minimum number of children of a sequence or a map to validate them in parallel
+    std::size_t parallel_threshold = 1024;
+    // stops the validation after this number of errors (0 = unlimited, 1 = fail-fast), also limits
+    // the errors of each failed variant
+    // note: with the executor, the reported errors may not be the first ones in the document order
+    std::size_t max_error_count = 0;
+    // caches valid pairs of document nodes and schema types during the validation, so repeated
+    // nodes (e.g. aliases) are validated once, requires NodeAccessor::identity
+    bool memoize = false;
+    // collects the counters of the validation if set, they are added to the existing ones
+    // note: the time is measured for each type dispatch, so the validation is slower
+    ValidationStats *stats = nullptr;
+};
+
+template <typename Node> struct GeneratedRuntime;
+template <typename Node> struct CompiledSchema;
+
 template <typename Node> class Validator {
   public:
     using Error = miroir::Error<Node>;
@@ -82,12 +182,60 @@ template <typename Node> class Validator {
     using TypeValidator = auto(*)(const Node &val) -> bool;
 
   public:
+    // compiles the schema, validator is immutable after the construction
     explicit Validator(const Node &schema,
                        const std::map<std::string, TypeValidator> &type_validators = {});
 
-    auto validate(const Node &doc) const -> std::vector<Error>;
+    // thread-safe: can be called concurrently on the same validator as long as the custom type
+    // validators and the NodeAccessor functions are safe to call concurrently
+    auto validate(const Node &doc, const ValidationOptions &options = {}) const
+        -> std::vector<Error>;
+    // same as validate(doc).empty(), but doesn't build errors and stops on the first one
+    auto is_valid(const Node &doc, const ValidationOptions &options = {}) const -> bool;
+    // validates documents in parallel if the executor is set, returns errors of each document
+    auto validate_batch(std::span<const Node> docs, const ValidationOptions &options = {}) const
+        -> std::vector<std::vector<Error>>;
+    // validates the document again after its nodes at changed_paths (written as the paths of the
+    // errors, e.g. "/items.0.name") are modified, added or removed: only the changed nodes and
+    // their ancestors are validated, errors of other nodes are copied from the previous errors,
+    // returns the same errors as validate
+    // note: errors must be returned by validate for the document before the changes, without the
+    // error limit, and the sequences with inserted or removed items must be given as changed
+    auto revalidate(const Node &doc, const std::vector<Error> &errors,
+                    std::span<const std::string> changed_paths,
+                    const ValidationOptions &options = {}) const -> std::vector<Error>;
+
+    // validates a document given as parser events, without building it in memory as a whole
+    class Stream;
+
+    // serializes the compiled schema into a versioned binary blob, so the validator can be created
+    // by deserialize without parsing and compiling the schema again
+    auto serialize() const -> std::string;
+    // creates the validator from the blob made by serialize, also by a validator of another node
+    // type, returns std::nullopt if the blob is corrupted or made by another format version
+    // note: the blob isn't referenced after the call, e.g. it can be a memory mapped file
+    // note: custom type validators aren't serialized and must be passed again, std::nullopt is
+    // returned if one of them is missing, expected values of the errors are strings rendered the
+    // same way as the nodes
+    static auto deserialize(std::string_view blob,
+                            const std::map<std::string, TypeValidator> &type_validators = {})
+        -> std::optional<Validator>;
 
   private:
+    // share the validation state, contexts and errors of the compiled schemas
+    template <typename OtherNode, typename Schema> friend class StaticValidator;
+    friend struct GeneratedRuntime<Node>;
+    friend struct CompiledSchema<Node>;
+
+    using Expected = std::variant<std::monostate, std::string, Node>;
+
+    // indices of the compiled types and schema nodes
+    using TypeId = std::size_t;
+    using SchemaNodeId = std::size_t;
+
+    // missing index, e.g. of a child not found in the map
+    static constexpr std::size_t npos = std::string::npos;
+
     struct SchemaSettings {
         bool default_required;
         std::string optional_tag;
@@ -106,73 +254,765 @@ template <typename Node> class Validator {
         std::vector<std::string> args;
     };
 
-    struct Context {
-        std::string path;
-        // note: prohibit assignment to a Node, since it may be a reference type, and assignment to
-        // an old node may invalidate/replace internal memory of that node (at least the yaml-cpp
-        // YAML::Node has this behavior)
-        const std::variant<std::monostate, std::string, Node> expected;
-        std::map<std::string, std::string> where;
+    enum class SchemaNodeKind {
+        Type,         // reference to a named type
+        AnySequence,  // empty sequence, takes any sequence
+        Sequence,     // sequence with one type, takes sequence of values of that type
+        ValueVariant, // `!variant` sequence, takes one of the listed values
+        TypeVariant,  // sequence of more than one type, takes value of one of the listed types
+        AnyMap,       // empty map, takes any map
+        Map,          // map with fields and/or typed keys
+    };
+
+    struct MapField {
+        std::string key; // empty for embedded fields
+        SchemaNodeId node;
+        bool is_required;
         bool is_embed;
+    };
+
+    struct MapKeyType {
+        Expected name; // key type as written in the schema
+        TypeId type;
+        SchemaNodeId node;
+        bool is_required;
+    };
+
+    // kind of the document node a schema node can match
+    enum class ShapeKind {
+        Any,      // any node, the schema node is validated to find out
+        Sequence, // sequence only
+        Map,      // map only, with the required fields
+    };
+
+    struct ShapeField {
+        std::string key;
+        SchemaNodeId values; // `!variant` node of the field value, npos if the value isn't checked
+    };
+
+    // necessary conditions for a document node to match a schema node, cheap to check
+    struct Shape {
+        ShapeKind kind;
+        std::vector<ShapeField> fields; // Map, required fields
+    };
+
+    // schema node with resolved type references and generic args
+    struct SchemaNode {
+        SchemaNodeKind kind;
+        // expected value of the errors: name of the referenced type or the schema node itself
+        Expected expected;
+
+        TypeId type;                        // Type
+        std::vector<SchemaNodeId> children; // Sequence, TypeVariant
+        std::vector<Shape> shapes;          // TypeVariant, shapes of the children
+        std::vector<Node> values;           // ValueVariant
+        // ValueVariant, hash of the value -> index of the value, requires NodeAccessor::hash
+        std::unordered_multimap<std::size_t, std::size_t> value_indices;
+        // ValueVariant of the deserialized validator, the values aren't nodes and are compared by
+        // the contents of the plain scalars (sorted) and by the dumps of other values
+        std::vector<std::string> value_scalars;
+        std::vector<std::string> value_dumps;
+        std::vector<MapField> fields;       // Map, in the schema order
+        // Map, key -> index of the field
+        std::map<std::string, std::size_t, std::less<>> field_indices;
+        std::vector<MapKeyType> key_types;  // Map
+        bool has_required_fields;           // Map
+    };
+
+    // built-in/custom type validator or an instance of the schema type
+    struct Type {
+        std::string name;
+        TypeValidator validator; // nullptr for schema types
+        SchemaNodeId node;       // schema types only
+    };
+
+    // generic schema type with parsed params
+    struct GenericSchemaType {
+        GenericType type;
+        Node node;
+    };
+
+    // state of the schema compilation, used only during the validator construction
+    struct CompileContext {
+        const std::map<std::string, Node> types;
+        const std::map<std::string, GenericSchemaType> generic_types; // generic name -> type
+        const std::map<std::string, TypeValidator> validators;
+        std::map<std::string, TypeId> type_ids; // concrete type name -> compiled type
+        std::size_t generic_depth;
+    };
+
+    // key-value pair of the document map
+    struct MapChild {
+        Node key;
+        Node value;
+        std::size_t key_type; // index of the first matching key type of the map, npos if none
+        bool is_validated;    // validated by a field or a key type of the map
+    };
+
+    // document node validated against the schema type
+    struct MemoKey {
+        const void *node; // NodeAccessor::identity
+        TypeId type;
+
+        auto operator==(const MemoKey &other) const -> bool = default;
+    };
+
+    struct MemoKeyHash {
+        auto operator()(const MemoKey &key) const -> std::size_t;
+    };
+
+    // state of the validation running in a single thread, reused between the documents of a batch
+    struct State {
+        const ValidationOptions &options;
+        // children of the document maps, buffers are reused to avoid allocations
+        std::vector<std::vector<MapChild>> children_buffers;
+        // valid nodes, used if ValidationOptions::memoize is set, cleared for each document
+        std::unordered_set<MemoKey, MemoKeyHash> valid_nodes;
+        // ValidationOptions::stats or the stats of the thread merged into them, nullptr if the
+        // stats aren't collected
+        ValidationStats *stats;
+
+        auto acquire_children() -> std::vector<MapChild>;
+        void release_children(std::vector<MapChild> &&children);
+    };
+
+    // records the dispatch of the type into the stats, the time is recorded at the end of scope
+    struct TypeDispatch {
+        ValidationStats::TypeStats *type_stats; // nullptr if the stats aren't collected
+        std::chrono::steady_clock::time_point start;
+
+        TypeDispatch(ValidationStats *stats, const std::string &type_name);
+        ~TypeDispatch();
+
+        TypeDispatch(const TypeDispatch &) = delete;
+        auto operator=(const TypeDispatch &) -> TypeDispatch & = delete;
+    };
+
+    // counts errors of the resulting list, shared between the threads validating the document
+    struct ErrorCounter {
+        const std::size_t max_count; // 0 = unlimited
+        std::atomic<std::size_t> count;
+
+        explicit ErrorCounter(std::size_t max_count) : max_count{max_count}, count{0} {}
+
+        // returns false if the error can't be added because the limit is reached
+        auto try_add() -> bool;
+        auto is_full() const -> bool;
+        auto has_errors() const -> bool;
+    };
 
-        explicit Context(const Node &expected)
-            : path{"/"}, expected{expected}, where{}, is_embed{false} {}
+    // children of the document map claimed by the embedded schema nodes, others are undefined
+    struct EmbedClaims {
+        std::vector<char> children; // claimed flags by the position of the child in the map
+        bool is_all;                // embedded schema node isn't a map, so it claims all children
 
-        explicit Context(const Context &other,
-                         const std::variant<std::monostate, std::string, Node> &expected)
-            : path{other.path}, expected{expected}, where{other.where}, is_embed{other.is_embed} {}
+        void claim(std::size_t index);
+        void claim(const EmbedClaims &claims);
+        auto is_claimed(std::size_t index) const -> bool;
+    };
+
+    enum class PathSegmentKind {
+        Root,    // "/"
+        Key,     // key of the schema map field
+        KeyNode, // key of the document map node
+        Index,   // index of the document sequence node
+    };
+
+    // node path as a chain of segments, rendered into a string only when an error is added
+    struct PathSegment {
+        PathSegmentKind kind;
+        const PathSegment *parent; // nullptr for the root
+        const std::string *key;    // Key
+        const Node *key_node;      // KeyNode
+        std::size_t index;         // Index
+
+        void render(std::string &path) const;
+    };
+
+    // hash of the strings allowing lookup by std::string_view
+    struct StringHash {
+        using is_transparent = void;
+
+        auto operator()(std::string_view str) const -> std::size_t {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    // previous errors of the document validated again by revalidate
+    struct Revalidation {
+        enum class Change {
+            None,        // node and its descendants are unchanged, the previous errors are reused
+            Descendants, // some descendants are changed
+            Subtree,     // node itself or its ancestor is changed, the subtree is validated again
+        };
+
+        const std::vector<Error> &errors;
+        // path of the node -> range of the previous errors of the node and its descendants, they
+        // are contiguous since the nodes are validated one by one (except the duplicated keys and
+        // the nodes validated more than once, see repeated_paths)
+        std::unordered_map<std::string, std::pair<std::size_t, std::size_t>, StringHash,
+                           std::equal_to<>>
+            error_ranges;
+        std::unordered_set<std::string, StringHash, std::equal_to<>> changed_paths;
+        // ancestors of the changed paths except the root
+        std::unordered_set<std::string, StringHash, std::equal_to<>> changed_ancestors;
+        // paths with the reused errors, shared between the threads validating the document
+        mutable std::mutex mutex;
+        mutable std::unordered_set<std::string, StringHash, std::equal_to<>> reused_paths;
+        // paths reached more than once (e.g. by a field and by an embedded field with the same
+        // key), errors of each time can't be told apart, so the nodes must be validated again
+        mutable std::vector<std::string> repeated_paths;
+
+        Revalidation(const std::vector<Error> &errors, std::span<const std::string> changed_paths);
+
+        auto find_change(std::string_view path) const -> Change;
+        // returns false if the errors of the path are already reused
+        auto reuse(const std::string &path) const -> bool;
+    };
 
-        auto appending_path(const std::string &suffix) const -> Context;
-        auto with_expected(const std::variant<std::monostate, std::string, Node> &expected) const
-            -> Context;
-        auto with_where(const std::map<std::string, std::string> &where) const -> Context;
-        auto with_embed() const -> Context;
+    // note: path of the context references the path of the parent context, so the child context
+    // must not outlive the parent one
+    struct Context {
+        PathSegment path;
+        const Expected *expected;
+        State *state;
+        ErrorCounter *error_counter;
+        EmbedClaims *embed_claims; // set if the node is embedded into the parent map
+        bool is_check_only;        // only validity is needed, errors aren't built
+        // set if the errors of the unchanged nodes are reused, see revalidate
+        const Revalidation *revalidation;
+
+        explicit Context(const Expected &expected, State &state, ErrorCounter &error_counter)
+            : path{PathSegmentKind::Root, nullptr, nullptr, nullptr, 0}, expected{&expected},
+              state{&state}, error_counter{&error_counter}, embed_claims{nullptr},
+              is_check_only{false}, revalidation{nullptr} {}
+
+        auto appending_path(const std::string &key) const -> Context;
+        auto appending_index(std::size_t index) const -> Context;
+        auto appending_key(const Node &key) const -> Context;
+        auto with_expected(const Expected &expected) const -> Context;
+        auto with_embed(EmbedClaims &embed_claims) const -> Context;
+        auto with_state(State &state) const -> Context;
+        auto with_error_counter(ErrorCounter &error_counter) const -> Context;
+        auto with_check_only() const -> Context;
+
+        // returns true if the error limit is reached and the validation can be stopped
+        auto is_stopped() const -> bool;
     };
 
   private:
+    // creates the validator from the deserialized compiled schema
+    Validator(const SchemaSettings &settings, std::vector<Type> &&types,
+              std::vector<SchemaNode> &&nodes, SchemaNodeId root);
+
+    static auto builtin_validators() -> const std::map<std::string, TypeValidator> &;
     static auto schema_settings(const Node &schema) -> SchemaSettings;
+    // returns false if the settings break the invariants asserted by schema_settings
+    static auto settings_are_valid(const SchemaSettings &settings) -> bool;
     static auto schema_types(const Node &schema) -> std::map<std::string, Node>;
     static auto schema_root(const Node &schema) -> Node;
 
   private:
-    auto make_error(ErrorType type, const Context &ctx,
-                    const std::vector<std::vector<Error>> &variant_errors = {}) const -> Error;
+    auto generic_schema_types(const std::map<std::string, Node> &types) const
+        -> std::map<std::string, GenericSchemaType>;
+
+    auto compile(const Node &schema, const std::map<std::string, std::string> &where,
+                 CompileContext &cc) -> SchemaNodeId;
+    auto compile_type(const std::string &type, const std::map<std::string, std::string> &where,
+                      CompileContext &cc) -> TypeId;
+    void compile_sequence(const Node &schema, const std::map<std::string, std::string> &where,
+                          CompileContext &cc, SchemaNode &node);
+    void compile_map(const Node &schema, const std::map<std::string, std::string> &where,
+                     CompileContext &cc, SchemaNode &node);
+    auto make_type(const std::string &name, TypeValidator validator, CompileContext &cc) -> TypeId;
+    // computes shapes of the type variants, called after the whole schema is compiled
+    void compile_shapes();
+    auto compile_shape(SchemaNodeId node_id) const -> Shape;
+    // returns the node referenced by the schema type, or the node itself
+    auto resolve_node(SchemaNodeId node_id) const -> SchemaNodeId;
+
+  private:
+    // adds the error if the error limit isn't reached
+    static void add_error(ErrorType type, const Context &ctx, std::vector<Error> &errors,
+                          std::vector<std::vector<Error>> &&variant_errors = {});
 
-    void validate(const Node &doc, const Node &schema, const Context &ctx,
+    void validate(const Node &doc, const SchemaNode &schema, const Context &ctx,
                   std::vector<Error> &errors) const;
+    // reuses the previous errors of the node if it's unchanged or validates the changed subtree,
+    // returns false if the node must be validated as usual
+    auto revalidate(const Node &doc, const SchemaNode &schema, const Context &ctx,
+                    std::vector<Error> &errors) const -> bool;
 
-    void validate_type(const Node &doc, const std::string &type, const Context &ctx,
+    void validate_type(const Node &doc, const SchemaNode &schema, const Context &ctx,
                        std::vector<Error> &errors) const;
-    auto validate_type(const Node &doc, const std::string &type, const Context &ctx) const -> bool;
+    auto validate_type(const Node &doc, TypeId type_id, const Context &ctx) const -> bool;
+    // validates the node against the schema type, skips the node if it's memoized as valid
+    void validate_memoized(const Node &doc, TypeId type_id, const Context &ctx,
+                           std::vector<Error> &errors) const;
 
-    void validate_scalar(const Node &doc, const Node &schema, const Context &ctx,
-                         std::vector<Error> &errors) const;
-    void validate_sequence(const Node &doc, const Node &schema, const Context &ctx,
+    void validate_sequence(const Node &doc, const SchemaNode &schema, const Context &ctx,
                            std::vector<Error> &errors) const;
-    void validate_map(const Node &doc, const Node &schema, const Context &ctx,
+    void validate_map(const Node &doc, const SchemaNode &schema, const Context &ctx,
                       std::vector<Error> &errors) const;
 
+    // calls validate_range(begin, end, ctx, errors) for the chunks of [0, count), in parallel if
+    // possible, and appends errors of the chunks in order
+    template <typename ValidateRange>
+    void validate_chunks(std::size_t count, const Context &ctx, std::vector<Error> &errors,
+                         const ValidateRange &validate_range) const;
+
     auto tag_is_optional(const std::string &tag) const -> bool;
     auto tag_is_embed(const std::string &tag) const -> bool;
     auto tag_is_variant(const std::string &tag) const -> bool;
     auto tag_is_required(const std::string &tag) const -> bool;
 
-    auto find_node(const Node &map, const std::string &key) const -> std::optional<Node>;
+    // returns true if the document node is one of the `!variant` values
+    auto variant_contains(const SchemaNode &schema, const Node &doc) const -> bool;
+    // returns false if the document node can't match the schema node of the shape
+    auto matches_shape(const Node &doc, const Shape &shape) const -> bool;
+    // returns value of the map child for the field key, found the same way as in find_fields
+    auto find_value(const Node &doc, const std::string &key) const -> std::optional<Node>;
+
+    // returns positions of the children for the map fields, npos for the children not found
+    auto find_fields(const SchemaNode &schema, const std::vector<MapChild> &children) const
+        -> std::vector<std::size_t>;
 
     auto type_is_generic(const std::string &type) const -> bool;
     auto parse_generic_type(const std::string &type) const -> GenericType;
+    auto concrete_type(const std::string &type,
+                       const std::map<std::string, std::string> &where) const -> std::string;
     auto make_generic_args(const GenericType &keys, const GenericType &vals,
                            const std::map<std::string, std::string> &where) const
         -> std::map<std::string, std::string>;
 
   private:
     const SchemaSettings m_settings;
-    const std::map<std::string, Node> m_types;
-    const Node m_root;
 
-    std::map<std::string, TypeValidator> m_validators;
+    // compiled schema, immutable after the construction
+    std::vector<Type> m_types;
+    std::vector<SchemaNode> m_nodes;
+    SchemaNodeId m_root;
+};
+
+// validates a document given as parser events (e.g. of the yaml-cpp parser), so only the nodes
+// validated as a whole (keys, scalars, type variants, maps with embedded nodes, etc.) are built by
+// the caller on request, and the memory depends on the nesting depth instead of the document size
+// note: errors are the same as of Validator::validate, but they may be not the first ones in the
+// document order if the error limit is reached, e.g. undefined children of a map are reported as
+// soon as their keys are read, before the missing fields
+template <typename Node> class Validator<Node>::Stream {
+  public:
+    explicit Stream(const Validator &validator, const ValidationOptions &options = {});
+
+    Stream(const Stream &) = delete;
+    auto operator=(const Stream &) -> Stream & = delete;
+
+    // called on the start of a sequence/map, returns true if its children must be passed as
+    // events, otherwise the whole sequence/map must be passed to node()
+    auto begin_sequence() -> bool;
+    auto begin_map() -> bool;
+    // called on the end of the sequence/map passed as events
+    void end();
+    // called with the whole node: scalar, alias or sequence/map built on request
+    void node(const Node &node);
+
+    // returns errors of the document and resets the stream for the next one
+    auto finish() -> std::vector<Error>;
+
+  private:
+    enum class FrameKind {
+        Root,     // document, takes the root node
+        Sequence, // sequence validated item by item
+        Map,      // map without embedded nodes validated child by child
+        Skip,     // node which doesn't need validation (e.g. undefined one), depth of the nested
+                  // nodes is counted
+    };
+
+    // destination of the next node: its schema node, context and errors
+    struct Slot {
+        const SchemaNode *schema;
+        Context ctx;
+        std::vector<Error> *errors;
+    };
+
+    // errors of the map child, sorted by the position of the child when the map ends, only the
+    // children with errors are kept, so the memory doesn't depend on the map size
+    struct ChildErrors {
+        std::size_t position;
+        std::vector<Error> errors;
+    };
+
+    // child with an attribute in the key, matched at the end of the map, because a child with the
+    // exact key takes the field first
+    struct PendingChild {
+        std::size_t position;
+        Node key;
+        Node value;
+        std::size_t field;
+    };
+
+    // note: contexts of the frames reference the paths of the parent frames, so the frames are
+    // stored in a deque to keep them in place
+    struct Frame {
+        FrameKind kind;
+        const SchemaNode *schema;   // Sequence, Map
+        Context ctx;                // context of the node itself
+        std::vector<Error> *errors; // errors of the node are added here
+        // Root/Sequence: number of the taken nodes, Map: position of the current child, Skip: depth
+        std::size_t count;
+
+        // Map, current child: the key, then the value
+        std::optional<Node> key;
+        std::optional<Slot> value;  // nullopt if the child is undefined or pending
+        std::size_t pending_field;  // field of the pending child, npos if the child isn't pending
+        std::size_t key_type;       // key type of the child, npos if the key isn't matched with one
+        std::vector<Error> child_errors; // errors of the child matched with the key type
+
+        // Map, errors are grouped in the order of Validator::validate_map
+        std::vector<std::vector<Error>> field_errors;
+        std::vector<char> field_is_found;
+        std::vector<std::vector<ChildErrors>> key_type_errors;
+        std::vector<char> key_type_is_found;
+        std::vector<ChildErrors> undefined_errors; // reported when the key is matched
+        std::vector<PendingChild> pending_children;
+    };
+
+    // starts the sequence/map, returns false if the node must be passed as a whole
+    auto begin(bool is_sequence) -> bool;
+    void push_frame(FrameKind kind, const SchemaNode *schema, const Context &ctx,
+                    std::vector<Error> *errors);
+    // marks the current node of the frame as taken
+    void take(Frame &frame);
+    // returns destination of the next node of the frame, nullopt if the node isn't validated
+    auto next_slot(Frame &frame) const -> std::optional<Slot>;
+    // matches the key of the map child with the fields and the key types
+    void add_key(Frame &frame, const Node &key);
+    // matches the key of the child not taken by a field with the key types, reports the child if
+    // it's undefined
+    auto match_key_types(Frame &frame, const Node &key, std::size_t position)
+        -> std::optional<Slot>;
+    // keeps errors of the child matched with the key type, if any
+    void add_child_errors(Frame &frame, std::size_t position);
+    // validates the pending children and adds errors of the map in the order of validate_map
+    void finish_map(Frame &frame);
+
+  private:
+    const Validator &m_validator;
+    const ValidationOptions m_options;
+    State m_state;
+    ErrorCounter m_error_counter;
+    std::deque<Frame> m_frames;
+    std::vector<Error> m_errors;
+};
+
+// schema given as C++ types, checked while compiling and validated by StaticValidator, e.g.:
+//
+//   types:
+//     endpoint: { host: string, port: integer, tls: !optional boolean }
+//   root:
+//     name: string
+//     endpoints: [endpoint]
+//     mode: !variant [fast, slow]
+//
+// is written as:
+//
+//   using namespace miroir::schema;
+//   using Endpoint = Type<"endpoint", Struct<Field<"host", String>, Field<"port", Integer>,
+//                                            Optional<"tls", Boolean>>>;
+//   using Root = Struct<Field<"name", String>, Field<"endpoints", Seq<Endpoint>>,
+//                       Field<"mode", Values<"fast", "slow">>>;
+//
+// generic types are C++ templates, recursive types are declared as structs:
+//
+//   struct Tree : Type<"tree", Struct<Field<"children", Seq<Tree>>>> {};
+namespace schema {
+
+// string literal as a template argument
+template <std::size_t N> struct Name {
+    char chars[N];
+
+    consteval Name(const char (&str)[N]) : chars{} {
+        for (std::size_t i = 0; i < N; ++i) {
+            chars[i] = str[i];
+        }
+    }
+
+    constexpr auto view() const -> std::string_view { return {chars, N - 1}; }
+};
+
+enum class BuiltinKind {
+    Any,
+    Map,
+    List,
+    Scalar,
+    Numeric,
+    Integer,
+    Boolean,
+    String,
+};
+
+constexpr auto builtin_name(BuiltinKind kind) -> std::string_view {
+    switch (kind) {
+    case BuiltinKind::Any:
+        return "any";
+    case BuiltinKind::Map:
+        return "map";
+    case BuiltinKind::List:
+        return "list";
+    case BuiltinKind::Scalar:
+        return "scalar";
+    case BuiltinKind::Numeric:
+        return "numeric";
+    case BuiltinKind::Integer:
+        return "integer";
+    case BuiltinKind::Boolean:
+        return "boolean";
+    case BuiltinKind::String:
+        return "string";
+    }
+
+    return "";
+}
+
+// built-in type
+template <BuiltinKind Kind> struct Builtin {
+    static constexpr BuiltinKind kind = Kind;
+    static constexpr std::string_view name = builtin_name(Kind);
+};
+
+using Any = Builtin<BuiltinKind::Any>;
+using Map = Builtin<BuiltinKind::Map>;
+using List = Builtin<BuiltinKind::List>;
+using Scalar = Builtin<BuiltinKind::Scalar>;
+using Numeric = Builtin<BuiltinKind::Numeric>;
+using Integer = Builtin<BuiltinKind::Integer>;
+using Boolean = Builtin<BuiltinKind::Boolean>;
+using String = Builtin<BuiltinKind::String>;
+
+// custom type, Function is called as `bool(const Node &)`
+template <Name TypeName, auto Function> struct Custom {
+    static constexpr std::string_view name = TypeName.view();
+    static constexpr auto function = Function;
+};
+
+// named type, errors of the definition report the name as the expected type
+template <Name TypeName, typename Definition> struct Type {
+    static constexpr std::string_view name = TypeName.view();
+    using definition = Definition;
+};
+
+// `[T]`, sequence of values of the type
+template <typename T> struct Seq {
+    using item = T;
+};
+
+// `[A, B, ...]`, type variant
+template <typename... Ts> struct OneOf {
+    static_assert(sizeof...(Ts) >= 2, "type variant must have at least two types");
+};
+
+// `!variant [a, b, ...]`, value variant, takes plain or quoted scalars equal to one of the values
+template <Name... Vs> struct Values {
+    static_assert(sizeof...(Vs) >= 1, "value variant must have at least one value");
+};
+
+// `{ ... }`, map of the members below, takes any map if there are no members
+template <typename... Members> struct Struct {};
 
-    mutable std::map<std::string, GenericType> m_generic_types_cache;
+// `key: T` and `key: !optional T`
+template <Name Key, typename T, bool IsRequired = true> struct Field {
+    static constexpr std::string_view key = Key.view();
+    static constexpr bool is_required = IsRequired;
+    using value = T;
+};
+
+template <Name Key, typename T> using Optional = Field<Key, T, false>;
+
+// `_: !embed T`
+template <typename T> struct Embed {
+    static constexpr bool is_required = false;
+    using embedded = T;
+};
+
+// `$K: T` and `$K: !optional T`, K is a built-in, custom or named type
+template <typename K, typename T, bool IsRequired = true> struct Keys {
+    static constexpr bool is_required = IsRequired;
+    using key_type = K;
+    using value = T;
+};
+
+template <typename K, typename T> using OptionalKeys = Keys<K, T, false>;
+
+} // namespace schema
+
+// validates documents against the schema given as C++ types (see miroir::schema), so the schema is
+// resolved while compiling: the types are dispatched statically, the keys of the maps and the
+// `!variant` values are sorted into constant tables, and errors in the schema (e.g. a duplicated
+// key) are compile errors
+// note: errors are the same as of Validator::validate with the equivalent schema
+template <typename Node, typename Schema> class StaticValidator {
+  public:
+    using Error = miroir::Error<Node>;
+    using NodeAccessor = miroir::NodeAccessor<Node>;
+
+  public:
+    // same as Validator::validate with ValidationOptions::max_error_count (0 = unlimited), other
+    // options aren't supported
+    auto validate(const Node &doc, std::size_t max_error_count = 0) const -> std::vector<Error>;
+    // same as validate(doc).empty(), but doesn't build errors and stops on the first one
+    auto is_valid(const Node &doc) const -> bool;
+
+  private:
+    using Base = Validator<Node>;
+    using Expected = typename Base::Expected;
+    using MapChild = typename Base::MapChild;
+    using State = typename Base::State;
+    using ErrorCounter = typename Base::ErrorCounter;
+    using EmbedClaims = typename Base::EmbedClaims;
+    using Context = typename Base::Context;
+
+    static constexpr std::size_t npos = Base::npos;
+
+  private:
+    // returns the schema type as dumped from the equivalent schema node, e.g. `[integer]`
+    template <typename T> static auto render() -> std::string;
+    // returns expected value of the errors of the unnamed schema type, as made by dump_expected
+    template <typename T> static auto expected() -> const Expected &;
+
+    template <typename T>
+    static void validate(const Node &doc, const Context &ctx, std::vector<Error> &errors);
+    // returns true if the key matches the key type
+    template <typename K> static auto validate_key(const Node &key, const Context &ctx) -> bool;
+
+    // overloads by the schema type, derived named types are passed as their bases
+    template <schema::BuiltinKind Kind>
+    static void validate_node(const Node &doc, const schema::Builtin<Kind> *type,
+                              const Context &ctx, std::vector<Error> &errors);
+    template <schema::Name TypeName, auto Function>
+    static void validate_node(const Node &doc, const schema::Custom<TypeName, Function> *type,
+                              const Context &ctx, std::vector<Error> &errors);
+    template <schema::Name TypeName, typename Definition>
+    static void validate_node(const Node &doc, const schema::Type<TypeName, Definition> *type,
+                              const Context &ctx, std::vector<Error> &errors);
+    template <typename T>
+    static void validate_node(const Node &doc, const schema::Seq<T> *type, const Context &ctx,
+                              std::vector<Error> &errors);
+    template <typename... Ts>
+    static void validate_node(const Node &doc, const schema::OneOf<Ts...> *type,
+                              const Context &ctx, std::vector<Error> &errors);
+    template <schema::Name... Vs>
+    static void validate_node(const Node &doc, const schema::Values<Vs...> *type,
+                              const Context &ctx, std::vector<Error> &errors);
+    template <typename... Members>
+    static void validate_node(const Node &doc, const schema::Struct<Members...> *type,
+                              const Context &ctx, std::vector<Error> &errors);
+
+    // validates the alternative of the type variant, returns true if the document node is valid
+    template <typename T>
+    static auto validate_variant(const Node &doc, const Context &ctx,
+                                 std::vector<Error> &variant_errors) -> bool;
+    // validates the field or the embedded type of the struct, key types are validated separately
+    template <typename Member>
+    static void validate_member(const Node &doc, std::vector<MapChild> &children,
+                                std::size_t child_index, const Context &ctx,
+                                EmbedClaims &embed_claims, std::vector<Error> &errors);
+    // matches the key of the child with the key type, returns false if it's not a key type
+    template <typename Member>
+    static auto match_key_type(MapChild &child, std::size_t member_index, const Context &ctx)
+        -> bool;
+    // validates the children matched with the key type
+    template <typename Member>
+    static void validate_key_type(std::vector<MapChild> &children, std::size_t member_index,
+                                  const Context &ctx, std::vector<Error> &errors);
+
+    // returns false if the document node can't match the schema type, see Validator::Shape
+    template <typename T> static auto matches_shape(const Node &doc) -> bool;
+};
+
+// runtime of the validators generated by the miroir_codegen tool from the schema files, shares the
+// validation state and errors with Validator, so the generated code reports the same errors as the
+// interpreted schema
+// note: used by the generated code only, see tools/miroir_codegen.cpp
+template <typename Node> struct GeneratedRuntime {
+    using Base = Validator<Node>;
+    using Error = miroir::Error<Node>;
+    using NodeAccessor = miroir::NodeAccessor<Node>;
+    using Expected = typename Base::Expected;
+    using Context = typename Base::Context;
+    using EmbedClaims = typename Base::EmbedClaims;
+    using MapChild = typename Base::MapChild;
+
+    // generated function validating the document node against the schema node
+    using Function = void (*)(const Node &doc, const Context &ctx, std::vector<Error> &errors);
+
+    static constexpr std::size_t npos = Base::npos;
+
+    // field of the map, tables of the fields are sorted by the key
+    struct Field {
+        std::string_view key;
+        std::size_t index; // index of the field in the map
+    };
+
+    // same as Validator::validate/is_valid with the root schema node, only the error limit of
+    // ValidationOptions is supported
+    static auto validate(const Node &doc, std::size_t max_error_count, const Expected &expected,
+                         Function root) -> std::vector<Error>;
+    static auto is_valid(const Node &doc, const Expected &expected, Function root) -> bool;
+
+    static void add_error(ErrorType type, const Context &ctx, std::vector<Error> &errors,
+                          std::vector<std::vector<Error>> &&variant_errors = {});
+
+    // validates the alternative of the type variant, returns true if the document node is valid
+    static auto validate_variant(const Node &doc, const Context &ctx, const Expected &expected,
+                                 Function variant, std::vector<Error> &variant_errors) -> bool;
+    // returns true if the key matches the schema type
+    static auto validate_key(const Node &key, const Context &ctx, Function type) -> bool;
+
+    // returns children of the document map, must be passed to finish_map
+    static auto begin_map(const Node &doc, const Context &ctx) -> std::vector<MapChild>;
+    // claims the validated children for the outer map or reports the undefined ones
+    static void finish_map(std::vector<MapChild> &&children, const EmbedClaims &claims,
+                           const Context &ctx, std::vector<Error> &errors);
+
+    // finds positions of the children for the fields the same way as Validator, npos for the
+    // fields not found, attribute_separator is '\0' if the attributes aren't ignored
+    static void find_fields(const std::vector<MapChild> &children, std::span<const Field> fields,
+                            char attribute_separator, std::span<std::size_t> field_children);
+    // returns value of the map child for the field key, found the same way as by find_fields
+    static auto find_value(const Node &doc, std::string_view key, char attribute_separator)
+        -> std::optional<Node>;
+    // returns true if the node is one of the `!variant` values: sorted plain scalars or the dumps
+    // of other values
+    static auto values_contain(const Node &doc, std::span<const std::string_view> scalars,
+                               std::span<const std::string_view> dumps) -> bool;
+};
+
+// read-only view of the schema compiled by Validator, e.g. to emit it as C++ code by the
+// miroir_codegen tool
+// note: the compiled schema isn't a stable interface and may change between the versions
+template <typename Node> struct CompiledSchema {
+    using Base = Validator<Node>;
+    using TypeValidator = typename Base::TypeValidator;
+    using Expected = typename Base::Expected;
+    using TypeId = typename Base::TypeId;
+    using SchemaNodeId = typename Base::SchemaNodeId;
+    using SchemaSettings = typename Base::SchemaSettings;
+    using SchemaNodeKind = typename Base::SchemaNodeKind;
+    using MapField = typename Base::MapField;
+    using MapKeyType = typename Base::MapKeyType;
+    using ShapeKind = typename Base::ShapeKind;
+    using ShapeField = typename Base::ShapeField;
+    using Shape = typename Base::Shape;
+    using SchemaNode = typename Base::SchemaNode;
+    using Type = typename Base::Type;
+
+    static constexpr std::size_t npos = Base::npos;
+
+    static auto settings(const Base &validator) -> const SchemaSettings &;
+    // types and schema nodes indexed by TypeId and SchemaNodeId
+    static auto types(const Base &validator) -> const std::vector<Type> &;
+    static auto nodes(const Base &validator) -> const std::vector<SchemaNode> &;
+    static auto root(const Base &validator) -> SchemaNodeId;
 };
 
 } // namespace miroir
@@ -182,10 +1022,17 @@ template <typename Node> class Validator {
 #ifdef MIROIR_IMPLEMENTATION
 
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <exception>
+#include <iterator>
 #include <limits>
-#include <set>
 #include <sstream>
 #include <string_view>
+#include <type_traits>
 
 // MIROIR_ASSERT macro
 #ifndef MIROIR_ASSERT
@@ -229,13 +1076,13 @@ auto string_is_prefixed(const std::string &str, const std::string &prefix) -> bo
     return str.compare(0, prefix.size(), prefix) == 0;
 }
 
-auto string_trim_after(const std::string &str, char c) -> std::string_view {
-    const std::string::size_type pos = str.find(c);
+auto string_trim_after(std::string_view str, char c) -> std::string_view {
+    const std::string_view::size_type pos = str.find(c);
 
-    if (pos != std::string::npos) {
-        return std::string_view{str}.substr(0, pos);
+    if (pos != std::string_view::npos) {
+        return str.substr(0, pos);
     } else {
-        return std::string_view{str};
+        return str;
     }
 }
 
@@ -256,17 +1103,19 @@ auto string_indent(const std::string &str) -> std::string {
     return result;
 }
 
-/// Nodes
-
-template <typename Node>
-auto nodes_contains_node(const std::vector<Node> &nodes, const Node &target) -> bool {
-    for (const Node &node : nodes) {
-        if (NodeAccessor<Node>::is_same(node, target)) {
-            return true;
+// calls fn with the path of each ancestor of the node except the root and with the path itself,
+// e.g. "/a" and "/a.b" for "/a.b"
+// note: keys with dots can't be told apart from the nested keys
+template <typename Fn> void for_each_path_prefix(std::string_view path, const Fn &fn) {
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        if (path[i] == '.') {
+            fn(path.substr(0, i));
         }
     }
 
-    return false;
+    if (path.size() > 1) {
+        fn(path);
+    }
 }
 
 /// Errors
@@ -319,49 +1168,126 @@ auto dump_variant_errors(const std::vector<std::vector<Error<Node>>> &variant_er
     return result;
 }
 
+// keeps the first max_count errors of each variant, as if they were limited during the validation
+template <typename Node> void limit_variant_errors(Error<Node> &error, std::size_t max_count) {
+    for (std::vector<Error<Node>> &errors : error.variant_errors) {
+        if (errors.size() > max_count) {
+            errors.resize(max_count);
+        }
+
+        for (Error<Node> &err : errors) {
+            limit_variant_errors(err, max_count);
+        }
+    }
+}
+
+/// Scalars
+
+enum class ScalarType {
+    Integer, // also a number
+    Number,
+    Boolean,
+    String,
+};
+
+// classifies the plain scalar in a single pass, numbers are parsed the same way as by std::istream
+auto classify_scalar(std::string_view val) -> ScalarType {
+    static constexpr std::string_view boolvals[] = {"y",    "n",     "yes", "no",
+                                                    "true", "false", "on",  "off"};
+
+    if (val.size() <= 5 && std::find(std::begin(boolvals), std::end(boolvals), val) !=
+                               std::end(boolvals)) {
+        return ScalarType::Boolean;
+    }
+
+    const char *first = val.data();
+    const char *last = val.data() + val.size();
+
+    // skip leading spaces and a plus sign not followed by another sign
+    while (first != last && std::isspace(static_cast<unsigned char>(*first))) {
+        ++first;
+    }
+
+    if (last - first >= 2 && first[0] == '+' && first[1] != '+' && first[1] != '-') {
+        ++first;
+    }
+
+    // numbers start with a digit or a point after an optional minus sign, this also excludes
+    // infinity and NaN accepted by std::from_chars
+    const char *digits = first != last && *first == '-' ? first + 1 : first;
+
+    if (digits == last || (!std::isdigit(static_cast<unsigned char>(*digits)) && *digits != '.')) {
+        return ScalarType::String;
+    }
+
+    long long integer;
+    const auto [integer_end, integer_ec] = std::from_chars(first, last, integer);
+
+    if (integer_ec == std::errc{} && integer_end == last) {
+        return ScalarType::Integer;
+    }
+
+    double number;
+    const auto [number_end, number_ec] = std::from_chars(first, last, number);
+
+    if (number_ec == std::errc{} && number_end == last) {
+        return ScalarType::Number;
+    }
+
+    if (number_ec == std::errc::result_out_of_range && number_end == last) {
+        // std::istream rejects overflow but accepts underflow
+        const double value = std::strtod(std::string{first, last}.c_str(), nullptr);
+        return std::isinf(value) ? ScalarType::String : ScalarType::Number;
+    }
+
+    return ScalarType::String;
+}
+
+// returns content of the scalar node, points to the node data if NodeAccessor::scalar_view is
+// provided, otherwise to the buffer
 template <typename Node>
-void filter_undefined_node_errors(std::vector<Error<Node>> &errors, std::size_t embed_count) {
-    using Error = Error<Node>;
+auto scalar_view(const Node &node, std::string &buffer) -> std::string_view {
+    using NodeAccessor = NodeAccessor<Node>;
 
-    // remove errors that are not present in all embedded nodes
-    errors.erase(std::remove_if(errors.begin(), errors.end(),
-                                [&errors, embed_count](const Error &remove_err) -> bool {
-                                    if (remove_err.type != ErrorType::UndefinedNode) {
-                                        return false;
-                                    }
+    if constexpr (requires { NodeAccessor::scalar_view(node); }) {
+        return NodeAccessor::scalar_view(node);
+    } else {
+        buffer = NodeAccessor::template as<std::string>(node);
+        return buffer;
+    }
+}
 
-                                    const std::size_t count = std::count_if(
-                                        errors.cbegin(), errors.cend(),
-                                        [&remove_err](const Error &count_err) -> bool {
-                                            return count_err.type == remove_err.type &&
-                                                   count_err.path == remove_err.path;
-                                        });
+// returns true if the node is one of the `!variant` values given without nodes: the sorted
+// contents of the plain scalars and the dumps of other values, compared the same way as by
+// NodeAccessor::equals
+template <typename Node, typename Scalars, typename Dumps>
+auto values_contain(const Node &doc, const Scalars &scalars, const Dumps &dumps) -> bool {
+    using NodeAccessor = NodeAccessor<Node>;
 
-                                    return count < embed_count + 1;
-                                }),
-                 errors.end());
+    // plain and quoted scalars are equal if their contents are equal
+    if (NodeAccessor::is_scalar(doc) && NodeAccessor::tag(doc).empty()) {
+        std::string buffer;
+        const std::string_view scalar = scalar_view(doc, buffer);
+        const auto it = std::lower_bound(std::begin(scalars), std::end(scalars), scalar);
 
-    // remove duplicate errors preserving the order and keeping only the last occurrence of error
-    std::set<std::pair<ErrorType, std::string>> visited_errors;
-    errors.erase(errors.begin(),
-                 std::stable_partition(errors.rbegin(), errors.rend(),
-                                       [&visited_errors](const Error &err) -> bool {
-                                           if (err.type != ErrorType::UndefinedNode) {
-                                               return true;
-                                           }
+        if (it != std::end(scalars) && *it == scalar) {
+            return true;
+        }
+    }
 
-                                           if (visited_errors.contains({err.type, err.path})) {
-                                               return false;
-                                           }
+    // other nodes are equal if their dumps are equal
+    if (std::empty(dumps)) {
+        return false;
+    }
 
-                                           visited_errors.insert({err.type, err.path});
-                                           return true;
-                                       })
-                     .base());
+    const std::string dump = NodeAccessor::dump(doc);
+    return std::find(std::begin(dumps), std::end(dumps), dump) != std::end(dumps);
 }
 
 /// Built-in validators
 
+template <typename Node> auto node_is_any(const Node & /*node*/) -> bool { return true; }
+
 template <typename Node> auto node_is_integer(const Node &node) -> bool {
     using NodeAccessor = NodeAccessor<Node>;
 
@@ -369,13 +1295,9 @@ template <typename Node> auto node_is_integer(const Node &node) -> bool {
         return false;
     }
 
-    const std::string val = NodeAccessor::template as<std::string>(node);
-    std::istringstream iss{val};
-
-    long long integer;
-    iss >> integer;
-
-    return iss.eof() && !iss.fail();
+    std::string buffer;
+    const std::string_view val = impl::scalar_view(node, buffer);
+    return impl::classify_scalar(val) == ScalarType::Integer;
 }
 
 template <typename Node> auto node_is_number(const Node &node) -> bool {
@@ -385,13 +1307,10 @@ template <typename Node> auto node_is_number(const Node &node) -> bool {
         return false;
     }
 
-    const std::string val = NodeAccessor::template as<std::string>(node);
-    std::istringstream iss{val};
-
-    double number;
-    iss >> number;
-
-    return iss.eof() && !iss.fail();
+    std::string buffer;
+    const std::string_view val = impl::scalar_view(node, buffer);
+    const ScalarType type = impl::classify_scalar(val);
+    return type == ScalarType::Integer || type == ScalarType::Number;
 }
 
 template <typename Node> auto node_is_boolean(const Node &node) -> bool {
@@ -401,24 +1320,9 @@ template <typename Node> auto node_is_boolean(const Node &node) -> bool {
         return false;
     }
 
-    static const struct {
-        std::string trueval, falseval;
-    } boolvals[] = {
-        {"y", "n"},
-        {"yes", "no"},
-        {"true", "false"},
-        {"on", "off"},
-    };
-
-    const std::string val = NodeAccessor::template as<std::string>(node);
-
-    for (const auto &boolval : boolvals) {
-        if (val == boolval.trueval || val == boolval.falseval) {
-            return true;
-        }
-    }
-
-    return false;
+    std::string buffer;
+    const std::string_view val = impl::scalar_view(node, buffer);
+    return impl::classify_scalar(val) == ScalarType::Boolean;
 }
 
 template <typename Node> auto node_is_string(const Node &node) -> bool {
@@ -433,718 +1337,4184 @@ template <typename Node> auto node_is_string(const Node &node) -> bool {
         return true;
     }
 
-    return !impl::node_is_integer(node) && !impl::node_is_number(node) &&
-           !impl::node_is_boolean(node);
+    std::string buffer;
+    const std::string_view val = impl::scalar_view(node, buffer);
+    return impl::classify_scalar(val) == ScalarType::String;
 }
 
-} // namespace impl
-
-/// Error
+/// Binary schema
 
-template <typename Node> auto Error<Node>::description(int max_depth) const -> std::string {
-    MIROIR_ASSERT(max_depth >= 0, "max_depth is negative");
+// header of the blobs made by Validator::serialize, the version is changed with the format
+constexpr std::string_view binary_schema_magic = "miroir";
+constexpr std::uint64_t binary_schema_version = 1;
 
-    if (max_depth == 0) {
-        max_depth = std::numeric_limits<int>::max();
+// writes integers in little-endian byte order and length-prefixed strings
+class BinaryWriter {
+  public:
+    void write_uint(std::uint64_t value) {
+        for (std::size_t i = 0; i < sizeof(value); ++i) {
+            m_data += static_cast<char>((value >> (i * 8)) & 0xff);
+        }
     }
 
-    --max_depth;
+    void write_bool(bool value) { m_data += static_cast<char>(value); }
 
-    // todo: (c++20) use std::format
-    switch (type) {
-    case ErrorType::NodeNotFound:
-        return path + ": node not found";
-    case ErrorType::InvalidValueType:
-        return path + ": expected value type: " + impl::dump_expected(expected) +
-               impl::dump_variant_errors(variant_errors, max_depth);
-    case ErrorType::InvalidValue:
-        return path + ": expected value: " + impl::dump_expected(expected);
-    case ErrorType::MissingKeyWithType:
-        return path + ": missing key with type: " + impl::dump_expected(expected);
-    case ErrorType::UndefinedNode:
-        return path + ": undefined node";
+    void write_string(std::string_view str) {
+        write_uint(str.size());
+        m_data += str;
     }
 
-    MIROIR_ASSERT(false, "invalid error type: " << static_cast<int>(type));
-    // todo: (c++23) use std::unreachable
-    impl::unreachable();
-}
+    auto data() && -> std::string { return std::move(m_data); }
 
-/// Context
+  private:
+    std::string m_data;
+};
 
-template <typename Node>
-auto Validator<Node>::Context::appending_path(const std::string &suffix) const -> Context {
-    Context ctx = *this;
-    // todo: (c++20) use std::format
-    ctx.path = path != "/" ? path + "." + suffix : path + suffix;
-    ctx.is_embed = false; // reset is_embed field when we're going deeper
-    return ctx;
-}
+// reads the data of BinaryWriter, fails instead of reading out of the bounds, so a corrupted blob
+// can't crash the reader
+class BinaryReader {
+  public:
+    explicit BinaryReader(std::string_view data) : m_data{data}, m_is_failed{false} {}
 
-template <typename Node>
-auto Validator<Node>::Context::with_expected(
-    const std::variant<std::monostate, std::string, Node> &expected) const -> Context {
+    auto read_uint() -> std::uint64_t {
+        if (m_data.size() < sizeof(std::uint64_t)) {
+            return fail();
+        }
 
-    // see a note for the expected field in the Context struct definition
-    return Context{*this, expected};
-}
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < sizeof(value); ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(m_data[i])) << (i * 8);
+        }
 
-template <typename Node>
-auto Validator<Node>::Context::with_where(const std::map<std::string, std::string> &where) const
-    -> Context {
+        m_data.remove_prefix(sizeof(value));
+        return value;
+    }
 
-    Context ctx = *this;
-    ctx.where = where;
-    return ctx;
-}
+    auto read_bool() -> bool {
+        if (m_data.empty() || static_cast<unsigned char>(m_data[0]) > 1) {
+            return fail();
+        }
 
-template <typename Node> auto Validator<Node>::Context::with_embed() const -> Context {
-    Context ctx = *this;
-    ctx.is_embed = true;
-    return ctx;
-}
+        const bool value = m_data[0] != 0;
+        m_data.remove_prefix(1);
+        return value;
+    }
 
-/// Validator
+    auto read_string() -> std::string {
+        const std::uint64_t size = read_uint();
 
-template <typename Node>
-Validator<Node>::Validator(const Node &schema,
-                           const std::map<std::string, TypeValidator> &type_validators)
-    : m_settings{schema_settings(schema)}, m_types{schema_types(schema)},
-      m_root{schema_root(schema)}, m_validators{type_validators} {
+        if (m_data.size() < size) {
+            fail();
+            return "";
+        }
 
-    // todo: add built-in generic types (list<T>, map<K;V>)
-    static const std::map<std::string, TypeValidator> builtin_validators = {
-        // basic
-        {"any", [](const Node &) -> bool { return true; }},
-        {"map", NodeAccessor::is_map},
-        {"list", NodeAccessor::is_sequence},
-        {"scalar", NodeAccessor::is_scalar},
+        std::string str{m_data.substr(0, size)};
+        m_data.remove_prefix(size);
+        return str;
+    }
 
-        // numeric
-        {"numeric", impl::node_is_number},
-        {"num", impl::node_is_number},
+    // reads number of the items, each of them takes at least one byte, so the count of a
+    // corrupted blob can't exceed the remaining size
+    auto read_count() -> std::size_t {
+        const std::uint64_t count = read_uint();
+        return count <= m_data.size() ? count : fail();
+    }
 
-        // integer
-        {"integer", impl::node_is_integer},
-        {"int", impl::node_is_integer},
+    auto is_failed() const -> bool { return m_is_failed; }
+    // returns true if the whole data is read successfully
+    auto is_finished() const -> bool { return !m_is_failed && m_data.empty(); }
 
-        // bool
-        {"boolean", impl::node_is_boolean},
-        {"bool", impl::node_is_boolean},
+  private:
+    auto fail() -> std::uint64_t {
+        m_is_failed = true;
+        m_data = {};
+        return 0;
+    }
 
-        // string
-        {"string", impl::node_is_string},
-        {"str", impl::node_is_string},
-    };
+  private:
+    std::string_view m_data;
+    bool m_is_failed;
+};
 
-    m_validators.insert(builtin_validators.cbegin(), builtin_validators.cend());
-}
+/// Static schemas
 
-template <typename Node>
-auto Validator<Node>::validate(const Node &doc) const -> std::vector<Error> {
-    const Context ctx{m_root};
-    std::vector<Error> errors;
-    validate(doc, m_root, ctx, errors);
-    return errors;
+template <typename T> constexpr bool is_static_named = requires { T::name; };
+template <typename T> constexpr bool is_static_seq = requires { typename T::item; };
+
+template <typename T> constexpr bool is_static_one_of = false;
+template <typename... Ts> constexpr bool is_static_one_of<schema::OneOf<Ts...>> = true;
+
+template <typename T> constexpr bool is_static_values = false;
+template <schema::Name... Vs> constexpr bool is_static_values<schema::Values<Vs...>> = true;
+
+template <typename T> constexpr bool is_static_struct = false;
+template <typename... Members> constexpr bool is_static_struct<schema::Struct<Members...>> = true;
+
+template <typename T>
+constexpr bool is_static_schema = is_static_named<T> || is_static_seq<T> || is_static_one_of<T> ||
+                                  is_static_values<T> || is_static_struct<T>;
+
+template <typename M> constexpr bool is_field_member = requires { M::key; };
+template <typename M> constexpr bool is_embed_member = requires { typename M::embedded; };
+template <typename M> constexpr bool is_key_type_member = requires { typename M::key_type; };
+
+// definition of the named schema type, or the schema type itself
+template <typename T> struct StaticDefinition {
+    using type = T;
+};
+
+template <typename T>
+    requires requires { typename T::definition; }
+struct StaticDefinition<T> {
+    using type = typename StaticDefinition<typename T::definition>::type;
+};
+
+template <schema::BuiltinKind Kind, typename Node> auto node_is_builtin(const Node &node) -> bool {
+    using NodeAccessor = NodeAccessor<Node>;
+
+    if constexpr (Kind == schema::BuiltinKind::Any) {
+        return impl::node_is_any(node);
+    } else if constexpr (Kind == schema::BuiltinKind::Map) {
+        return NodeAccessor::is_map(node);
+    } else if constexpr (Kind == schema::BuiltinKind::List) {
+        return NodeAccessor::is_sequence(node);
+    } else if constexpr (Kind == schema::BuiltinKind::Scalar) {
+        return NodeAccessor::is_scalar(node);
+    } else if constexpr (Kind == schema::BuiltinKind::Numeric) {
+        return impl::node_is_number(node);
+    } else if constexpr (Kind == schema::BuiltinKind::Integer) {
+        return impl::node_is_integer(node);
+    } else if constexpr (Kind == schema::BuiltinKind::Boolean) {
+        return impl::node_is_boolean(node);
+    } else {
+        return impl::node_is_string(node);
+    }
 }
 
-template <typename Node>
-auto Validator<Node>::schema_settings(const Node &schema) -> SchemaSettings {
-    SchemaSettings settings{
-        .default_required = true,
-        .optional_tag = "optional",
-        .required_tag = "required",
-        .embed_tag = "embed",
-        .variant_tag = "variant",
-        .key_type_prefix = "$",
-        .generic_brackets = "<>",
-        .generic_separator = ";",
-        .attribute_separator = ":",
-        .ignore_attributes = false,
+// values of the value variant sorted for the binary search
+template <typename T> struct StaticValues;
+
+template <schema::Name... Vs> struct StaticValues<schema::Values<Vs...>> {
+    static constexpr std::array<std::string_view, sizeof...(Vs)> values = [] {
+        std::array<std::string_view, sizeof...(Vs)> values{Vs.view()...};
+        std::sort(values.begin(), values.end());
+        return values;
+    }();
+
+    // returns true if the node is a plain or quoted scalar equal to one of the values
+    template <typename Node> static auto contains(const Node &node) -> bool {
+        using NodeAccessor = NodeAccessor<Node>;
+
+        if (!NodeAccessor::is_scalar(node) || !NodeAccessor::tag(node).empty()) {
+            return false;
+        }
+
+        std::string buffer;
+        return std::binary_search(values.begin(), values.end(), impl::scalar_view(node, buffer));
+    }
+};
+
+// fields of the struct sorted by the key for the binary search
+template <typename T> struct StaticStruct;
+
+template <typename... Members> struct StaticStruct<schema::Struct<Members...>> {
+    struct Field {
+        std::string_view key;
+        std::size_t member; // index of the member in the struct
     };
 
-    const Node settings_node = NodeAccessor::at(schema, "settings");
+    static constexpr std::size_t field_count = (std::size_t{is_field_member<Members>} + ... + 0);
 
-    if (NodeAccessor::is_defined(settings_node)) {
-        settings.default_required = NodeAccessor::as(
-            NodeAccessor::at(settings_node, "default_required"), settings.default_required);
-        settings.optional_tag = NodeAccessor::as(NodeAccessor::at(settings_node, "optional_tag"),
-                                                 settings.optional_tag);
-        settings.required_tag = NodeAccessor::as(NodeAccessor::at(settings_node, "required_tag"),
-                                                 settings.required_tag);
-        settings.embed_tag =
-            NodeAccessor::as(NodeAccessor::at(settings_node, "embed_tag"), settings.embed_tag);
-        settings.variant_tag =
-            NodeAccessor::as(NodeAccessor::at(settings_node, "variant_tag"), settings.variant_tag);
-        settings.key_type_prefix = NodeAccessor::as(
-            NodeAccessor::at(settings_node, "key_type_prefix"), settings.key_type_prefix);
-        settings.generic_brackets = NodeAccessor::as(
-            NodeAccessor::at(settings_node, "generic_brackets"), settings.generic_brackets);
-        settings.generic_separator = NodeAccessor::as(
-            NodeAccessor::at(settings_node, "generic_separator"), settings.generic_separator);
-        settings.attribute_separator = NodeAccessor::as(
-            NodeAccessor::at(settings_node, "attribute_separator"), settings.attribute_separator);
-        settings.ignore_attributes = NodeAccessor::as(
-            NodeAccessor::at(settings_node, "ignore_attributes"), settings.ignore_attributes);
+    static constexpr std::array<Field, field_count> fields = [] {
+        std::array<Field, field_count> fields{};
+        std::size_t field_index = 0;
+        std::size_t member_index = 0;
+
+        (
+            [&] {
+                if constexpr (is_field_member<Members>) {
+                    fields[field_index++] = Field{.key = Members::key, .member = member_index};
+                }
+
+                ++member_index;
+            }(),
+            ...);
+
+        std::sort(fields.begin(), fields.end(),
+                  [](const Field &lhs, const Field &rhs) -> bool { return lhs.key < rhs.key; });
+        return fields;
+    }();
+
+    static constexpr bool has_required_fields =
+        ((is_field_member<Members> && Members::is_required) || ...);
+    static constexpr bool has_key_types = (is_key_type_member<Members> || ...);
+
+    static constexpr auto has_unique_keys() -> bool {
+        return std::adjacent_find(fields.begin(), fields.end(),
+                                  [](const Field &lhs, const Field &rhs) -> bool {
+                                      return lhs.key == rhs.key;
+                                  }) == fields.end();
     }
 
-    MIROIR_ASSERT(!settings.optional_tag.empty(), "optional tag name is empty");
-    MIROIR_ASSERT(!settings.required_tag.empty(), "required tag name is empty");
-    MIROIR_ASSERT(!settings.embed_tag.empty(), "embed tag name is empty");
-    MIROIR_ASSERT(!settings.variant_tag.empty(), "variant tag name is empty");
-    MIROIR_ASSERT(!settings.key_type_prefix.empty(), "key type prefix is empty");
+    static_assert(has_unique_keys(), "struct has duplicated keys");
+    static_assert(((is_field_member<Members> || is_embed_member<Members> ||
+                    is_key_type_member<Members>) &&
+                   ...),
+                  "struct member must be a field, an embedded type or a key type");
 
-    MIROIR_ASSERT(settings.generic_brackets.size() == 2,
-                  "invalid generic brackets string length: " << settings.generic_brackets);
-    MIROIR_ASSERT(settings.generic_separator.size() == 1,
-                  "invalid generic separator string length: " << settings.generic_separator);
+    // returns index of the member of the field, npos if not found
+    static auto find(std::string_view key) -> std::size_t {
+        const auto it = std::lower_bound(
+            fields.begin(), fields.end(), key,
+            [](const Field &field, std::string_view key) -> bool { return field.key < key; });
 
-    MIROIR_ASSERT(settings.attribute_separator.size() == 1,
-                  "invalid attribute separator string length: " << settings.attribute_separator);
+        return it != fields.end() && it->key == key ? it->member : std::string::npos;
+    }
+};
 
-    return settings;
+// returns key of the field as a string referenced by the paths of the errors
+template <typename Field> auto static_field_key() -> const std::string & {
+    static const std::string key{Field::key};
+    return key;
 }
 
-template <typename Node>
-auto Validator<Node>::schema_types(const Node &schema) -> std::map<std::string, Node> {
-    return NodeAccessor::as(NodeAccessor::at(schema, "types"), std::map<std::string, Node>{});
-}
+} // namespace impl
 
-template <typename Node> auto Validator<Node>::schema_root(const Node &schema) -> Node {
-    MIROIR_ASSERT(NodeAccessor::is_map(schema),
-                  "schema is not a map: " << NodeAccessor::dump(schema));
-    const Node root = NodeAccessor::at(schema, "root");
-    MIROIR_ASSERT(NodeAccessor::is_defined(root), "missing root node in the schema");
-    return root;
-}
+/// Error
 
-template <typename Node>
-auto Validator<Node>::make_error(ErrorType type, const Context &ctx,
-                                 const std::vector<std::vector<Error>> &variant_errors) const
-    -> Error {
+template <typename Node> auto Error<Node>::description(int max_depth) const -> std::string {
+    MIROIR_ASSERT(max_depth >= 0, "max_depth is negative");
 
-    return Error{
-        .type = type,
-        .path = ctx.path,
-        .expected = ctx.expected,
-        .variant_errors = variant_errors,
-    };
+    if (max_depth == 0) {
+        max_depth = std::numeric_limits<int>::max();
+    }
+
+    --max_depth;
+
+    // todo: (c++20) use std::format
+    switch (type) {
+    case ErrorType::NodeNotFound:
+        return path + ": node not found";
+    case ErrorType::InvalidValueType:
+        return path + ": expected value type: " + impl::dump_expected(expected) +
+               impl::dump_variant_errors(variant_errors, max_depth);
+    case ErrorType::InvalidValue:
+        return path + ": expected value: " + impl::dump_expected(expected);
+    case ErrorType::MissingKeyWithType:
+        return path + ": missing key with type: " + impl::dump_expected(expected);
+    case ErrorType::UndefinedNode:
+        return path + ": undefined node";
+    }
+
+    MIROIR_ASSERT(false, "invalid error type: " << static_cast<int>(type));
+    // todo: (c++23) use std::unreachable
+    impl::unreachable();
 }
 
-template <typename Node>
-void Validator<Node>::validate(const Node &doc, const Node &schema, const Context &ctx,
-                               std::vector<Error> &errors) const {
+/// ValidationStats
 
-    if (NodeAccessor::is_scalar(schema)) {
-        validate_scalar(doc, schema, ctx, errors);
-    } else if (NodeAccessor::is_sequence(schema)) {
-        validate_sequence(doc, schema, ctx, errors);
-    } else if (NodeAccessor::is_map(schema)) {
-        validate_map(doc, schema, ctx, errors);
-    } else {
-        MIROIR_ASSERT(false, "invalid schema node: " << NodeAccessor::dump(schema));
+void ValidationStats::merge(const ValidationStats &other) {
+    node_count += other.node_count;
+    variant_attempt_count += other.variant_attempt_count;
+    variant_reject_count += other.variant_reject_count;
+    variant_skip_count += other.variant_skip_count;
+    key_probe_count += other.key_probe_count;
+
+    for (const auto &[name, type_stats] : other.types) {
+        TypeStats &merged_type_stats = types[name];
+        merged_type_stats.dispatch_count += type_stats.dispatch_count;
+        merged_type_stats.time += type_stats.time;
     }
 }
 
-template <typename Node>
-void Validator<Node>::validate_type(const Node &doc, const std::string &type, const Context &ctx,
-                                    std::vector<Error> &errors) const {
+/// ThreadPool
 
-    // generic args
-    // note: generic args can only contain names of other types, but not the types themselves, e.g.
-    // "generic<string>" is a valid type, but "generic<[string]>" is not, define and use an alias
-    // (e.g. "list<string>")
-    if (!ctx.where.empty()) {
-        const auto concrete_type_it = ctx.where.find(type);
+struct ThreadPool::Job {
+    const std::function<void(std::size_t)> &task;
+    const std::size_t count;
 
-        if (concrete_type_it != ctx.where.end()) {
-            const std::string &concrete_type = concrete_type_it->second;
-            validate_type(doc, concrete_type, ctx.with_expected(type).with_where({}), errors);
-            return;
-        }
+    std::atomic<std::size_t> next_index;
+    std::atomic<std::size_t> finished_count;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr exception; // first exception thrown by the task
+
+    Job(const std::function<void(std::size_t)> &task, std::size_t count)
+        : task{task}, count{count}, next_index{0}, finished_count{0} {}
+};
+
+ThreadPool::ThreadPool(std::size_t thread_count) : m_is_stopped{false} {
+    // the calling thread is one of the threads
+    for (std::size_t i = 1; i < thread_count; ++i) {
+        m_threads.emplace_back([this]() -> void { work(); });
     }
+}
 
-    // generic types
-    if (type_is_generic(type)) {
-        const GenericType generic_type = parse_generic_type(type);
+ThreadPool::~ThreadPool() {
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_is_stopped = true;
+    }
 
-        for (const auto &[schema_type, schema_type_node] : m_types) {
-            if (!type_is_generic(schema_type)) {
-                continue;
-            }
+    m_condition.notify_all();
 
-            const GenericType generic_schema_type = parse_generic_type(schema_type);
-            if (generic_type.name == generic_schema_type.name) {
-                const std::map<std::string, std::string> generic_args =
-                    make_generic_args(generic_schema_type, generic_type, ctx.where);
-                validate(doc, schema_type_node, ctx.with_expected(type).with_where(generic_args),
-                         errors);
-                return;
-            }
-        }
+    for (std::thread &thread : m_threads) {
+        thread.join();
     }
+}
 
-    // schema types
-    const auto type_it = m_types.find(type);
-    if (type_it != m_types.end()) {
-        const Node schema_type_node = type_it->second;
-        validate(doc, schema_type_node, ctx.with_expected(type).with_where({}), errors);
+auto ThreadPool::concurrency() const -> std::size_t { return m_threads.size() + 1; }
+
+void ThreadPool::run(std::size_t count, const std::function<void(std::size_t)> &task) {
+    if (count == 0) {
         return;
     }
 
-    // built-in types
-    const auto validator_it = m_validators.find(type);
-    if (validator_it != m_validators.end()) {
-        const TypeValidator type_validator = validator_it->second;
+    const std::shared_ptr<Job> job = std::make_shared<Job>(task, count);
 
-        if (!type_validator(doc)) {
-            // node has invalid type
-            const Error err = make_error(ErrorType::InvalidValueType, ctx.with_expected(type));
-            errors.push_back(err);
+    if (!m_threads.empty()) {
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            m_jobs.push_back(job);
         }
 
-        return;
+        m_condition.notify_all();
     }
 
-    MIROIR_ASSERT(false, "type not found: " << type);
-}
+    // don't just wait for the workers, they may be busy with the tasks of the outer job
+    execute(*job);
 
-template <typename Node>
-auto Validator<Node>::validate_type(const Node &doc, const std::string &type,
-                                    const Context &ctx) const -> bool {
+    {
+        std::unique_lock<std::mutex> lock{job->mutex};
+        job->finished.wait(lock, [&job]() -> bool { return job->finished_count == job->count; });
+    }
 
-    std::vector<Error> errors;
-    validate_type(doc, type, ctx.with_expected(type), errors);
-    return errors.empty();
+    if (job->exception) {
+        std::rethrow_exception(job->exception);
+    }
 }
 
-template <typename Node>
-void Validator<Node>::validate_scalar(const Node &doc, const Node &schema, const Context &ctx,
-                                      std::vector<Error> &errors) const {
+void ThreadPool::work() {
+    while (true) {
+        std::shared_ptr<Job> job;
 
-    const std::string type = NodeAccessor::template as<std::string>(schema);
-    validate_type(doc, type, ctx, errors);
-}
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_condition.wait(lock, [this]() -> bool { return m_is_stopped || !m_jobs.empty(); });
 
-template <typename Node>
-void Validator<Node>::validate_sequence(const Node &doc, const Node &schema, const Context &ctx,
-                                        std::vector<Error> &errors) const {
+            if (m_is_stopped) {
+                return;
+            }
 
-    const std::size_t schema_size = NodeAccessor::size(schema);
+            job = m_jobs.front();
 
-    if (schema_size == 0) {
-        if (!NodeAccessor::is_sequence(doc)) {
-            // schema node is an empty sequence but document node is not a sequence
-            const Error err = make_error(ErrorType::InvalidValueType, ctx);
-            errors.push_back(err);
+            if (job->next_index >= job->count) {
+                // all tasks of the job are taken
+                m_jobs.pop_front();
+                continue;
+            }
         }
 
-        // allow any sequence on empty sequence in the schema
-        return;
+        execute(*job);
     }
+}
 
-    const std::string schema_tag = NodeAccessor::tag(schema);
-
-    if (tag_is_variant(schema_tag)) {
-        for (auto it = NodeAccessor::begin(schema); it != NodeAccessor::end(schema); ++it) {
-            if (NodeAccessor::equals(doc, *it)) {
-                // found correct node value
-                return;
+void ThreadPool::execute(Job &job) {
+    for (std::size_t i = job.next_index++; i < job.count; i = job.next_index++) {
+        try {
+            job.task(i);
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock{job.mutex};
+            if (!job.exception) {
+                job.exception = std::current_exception();
             }
         }
 
-        // document node has invalid value
-        const Error err = make_error(ErrorType::InvalidValue, ctx);
-        errors.push_back(err);
-    } else if (schema_size == 1) {
-        const Node child_schema_node = NodeAccessor::at(schema, 0);
-
-        if (NodeAccessor::is_sequence(doc)) {
-            for (std::size_t i = 0; i < NodeAccessor::size(doc); ++i) {
-                const Node child_doc_node = NodeAccessor::at(doc, i);
-                validate(child_doc_node, child_schema_node, ctx.appending_path(std::to_string(i)),
-                         errors);
-            }
-        } else {
-            // schema node is a sequence but document node is not a sequence
-            const Error err = make_error(ErrorType::InvalidValueType, ctx);
-            errors.push_back(err);
+        if (++job.finished_count == job.count) {
+            const std::lock_guard<std::mutex> lock{job.mutex};
+            job.finished.notify_all();
         }
-    } else { // schema_size > 1
-        std::vector<std::vector<Error>> grouped_errors;
-        std::vector<Error> variant_errors;
+    }
+}
 
-        for (auto it = NodeAccessor::begin(schema); it != NodeAccessor::end(schema); ++it) {
-            const Node variant_schema = *it;
+/// Context
 
-            variant_errors.clear();
-            validate(doc, variant_schema, ctx.with_expected(variant_schema), variant_errors);
+template <typename Node>
+auto Validator<Node>::Context::appending_path(const std::string &key) const -> Context {
+    Context ctx = *this;
+    ctx.path = PathSegment{PathSegmentKind::Key, &path, &key, nullptr, 0};
+    ctx.embed_claims = nullptr; // reset embed_claims field when we're going deeper
+    return ctx;
+}
 
-            if (variant_errors.empty()) {
-                // found correct node type
-                return;
-            }
+template <typename Node>
+auto Validator<Node>::Context::appending_index(std::size_t index) const -> Context {
+    Context ctx = *this;
+    ctx.path = PathSegment{PathSegmentKind::Index, &path, nullptr, nullptr, index};
+    ctx.embed_claims = nullptr;
+    return ctx;
+}
 
-            grouped_errors.push_back(variant_errors);
-        }
+template <typename Node>
+auto Validator<Node>::Context::appending_key(const Node &key) const -> Context {
+    Context ctx = *this;
+    ctx.path = PathSegment{PathSegmentKind::KeyNode, &path, nullptr, &key, 0};
+    ctx.embed_claims = nullptr;
+    return ctx;
+}
+
+template <typename Node>
+auto Validator<Node>::Context::with_expected(const Expected &expected) const -> Context {
+    Context ctx = *this;
+    ctx.expected = &expected;
+    return ctx;
+}
+
+template <typename Node>
+auto Validator<Node>::Context::with_embed(EmbedClaims &embed_claims) const -> Context {
+    Context ctx = *this;
+    ctx.embed_claims = &embed_claims;
+    return ctx;
+}
+
+template <typename Node> auto Validator<Node>::Context::with_state(State &state) const -> Context {
+    Context ctx = *this;
+    ctx.state = &state;
+    return ctx;
+}
+
+template <typename Node>
+auto Validator<Node>::Context::with_error_counter(ErrorCounter &error_counter) const -> Context {
+    Context ctx = *this;
+    ctx.error_counter = &error_counter;
+    return ctx;
+}
+
+template <typename Node> auto Validator<Node>::Context::with_check_only() const -> Context {
+    Context ctx = *this;
+    ctx.is_check_only = true;
+    return ctx;
+}
+
+template <typename Node> auto Validator<Node>::Context::is_stopped() const -> bool {
+    return error_counter->is_full();
+}
+
+/// MemoKeyHash
+
+template <typename Node>
+auto Validator<Node>::MemoKeyHash::operator()(const MemoKey &key) const -> std::size_t {
+    const std::size_t node_hash = std::hash<const void *>{}(key.node);
+    return node_hash ^ (std::hash<TypeId>{}(key.type) + 0x9e3779b9 + (node_hash << 6) +
+                        (node_hash >> 2));
+}
+
+/// EmbedClaims
+
+template <typename Node> void Validator<Node>::EmbedClaims::claim(std::size_t index) {
+    if (index >= children.size()) {
+        children.resize(index + 1, false);
+    }
+
+    children[index] = true;
+}
+
+template <typename Node> void Validator<Node>::EmbedClaims::claim(const EmbedClaims &claims) {
+    for (std::size_t i = 0; i < claims.children.size(); ++i) {
+        if (claims.children[i]) {
+            claim(i);
+        }
+    }
+
+    is_all = is_all || claims.is_all;
+}
+
+template <typename Node>
+auto Validator<Node>::EmbedClaims::is_claimed(std::size_t index) const -> bool {
+    return is_all || (index < children.size() && children[index]);
+}
+
+/// PathSegment
+
+template <typename Node> void Validator<Node>::PathSegment::render(std::string &path) const {
+    if (parent == nullptr) {
+        path += "/";
+        return;
+    }
+
+    parent->render(path);
+
+    if (parent->parent != nullptr) {
+        path += ".";
+    }
+
+    switch (kind) {
+    case PathSegmentKind::Root:
+        return;
+    case PathSegmentKind::Key:
+        path += *key;
+        return;
+    case PathSegmentKind::KeyNode:
+        path += NodeAccessor::template as<std::string>(*key_node);
+        return;
+    case PathSegmentKind::Index:
+        path += std::to_string(index);
+        return;
+    }
+
+    MIROIR_ASSERT(false, "invalid path segment kind: " << static_cast<int>(kind));
+}
+
+/// Revalidation
+
+template <typename Node>
+Validator<Node>::Revalidation::Revalidation(const std::vector<Error> &errors,
+                                            std::span<const std::string> changed_paths)
+    : errors{errors}, error_ranges{}, changed_paths{changed_paths.begin(), changed_paths.end()},
+      changed_ancestors{} {
+
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        impl::for_each_path_prefix(errors[i].path, [&](std::string_view prefix) -> void {
+            const auto [it, is_inserted] = error_ranges.try_emplace(std::string{prefix}, i, i);
+
+            if (it->second.second != i) {
+                // errors of the path aren't contiguous (e.g. of the duplicated keys), so the
+                // node is validated again
+                this->changed_paths.emplace(prefix);
+            }
+
+            it->second.second = i + 1;
+        });
+    }
+
+    for (const std::string &path : this->changed_paths) {
+        impl::for_each_path_prefix(path, [&](std::string_view prefix) -> void {
+            if (prefix.size() < path.size()) {
+                changed_ancestors.emplace(prefix);
+            }
+        });
+    }
+}
+
+template <typename Node>
+auto Validator<Node>::Revalidation::find_change(std::string_view path) const -> Change {
+    Change change = Change::None;
+
+    impl::for_each_path_prefix(path, [&](std::string_view prefix) -> void {
+        if (changed_paths.contains(prefix)) {
+            change = Change::Subtree;
+        }
+    });
+
+    // root is the ancestor of any node
+    if (change == Change::None && (path == "/" || changed_ancestors.contains(path))) {
+        change = Change::Descendants;
+    }
+
+    return change;
+}
+
+template <typename Node>
+auto Validator<Node>::Revalidation::reuse(const std::string &path) const -> bool {
+    const std::lock_guard<std::mutex> lock{mutex};
+
+    if (reused_paths.insert(path).second) {
+        return true;
+    }
+
+    repeated_paths.push_back(path);
+    return false;
+}
+
+/// ErrorCounter
+
+template <typename Node> auto Validator<Node>::ErrorCounter::try_add() -> bool {
+    // counter isn't decremented, so no more than max_count errors are added by all threads
+    const std::size_t prev_count = count.fetch_add(1, std::memory_order_relaxed);
+    return max_count == 0 || prev_count < max_count;
+}
+
+template <typename Node> auto Validator<Node>::ErrorCounter::is_full() const -> bool {
+    return max_count != 0 && count.load(std::memory_order_relaxed) >= max_count;
+}
+
+template <typename Node> auto Validator<Node>::ErrorCounter::has_errors() const -> bool {
+    return count.load(std::memory_order_relaxed) != 0;
+}
+
+/// State
+
+template <typename Node>
+auto Validator<Node>::State::acquire_children() -> std::vector<MapChild> {
+    if (children_buffers.empty()) {
+        return {};
+    }
+
+    std::vector<MapChild> children = std::move(children_buffers.back());
+    children_buffers.pop_back();
+    return children;
+}
+
+template <typename Node>
+void Validator<Node>::State::release_children(std::vector<MapChild> &&children) {
+    // don't hold the document nodes after the validation
+    children.clear();
+    children_buffers.push_back(std::move(children));
+}
+
+/// TypeDispatch
+
+template <typename Node>
+Validator<Node>::TypeDispatch::TypeDispatch(ValidationStats *stats, const std::string &type_name)
+    : type_stats{stats != nullptr ? &stats->types[type_name] : nullptr}, start{} {
+
+    if (type_stats != nullptr) {
+        ++type_stats->dispatch_count;
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+template <typename Node> Validator<Node>::TypeDispatch::~TypeDispatch() {
+    if (type_stats != nullptr) {
+        type_stats->time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start);
+    }
+}
+
+/// Validator
+
+template <typename Node>
+Validator<Node>::Validator(const Node &schema,
+                           const std::map<std::string, TypeValidator> &type_validators)
+    : m_settings{schema_settings(schema)}, m_types{}, m_nodes{}, m_root{} {
+
+    std::map<std::string, TypeValidator> validators = type_validators;
+    validators.insert(builtin_validators().cbegin(), builtin_validators().cend());
+
+    const std::map<std::string, Node> types = schema_types(schema);
+
+    CompileContext cc{
+        .types = types,
+        .generic_types = generic_schema_types(types),
+        .validators = validators,
+        .type_ids = {},
+        .generic_depth = 0,
+    };
+
+    m_root = compile(schema_root(schema), {}, cc);
+    compile_shapes();
+}
+
+template <typename Node>
+Validator<Node>::Validator(const SchemaSettings &settings, std::vector<Type> &&types,
+                           std::vector<SchemaNode> &&nodes, SchemaNodeId root)
+    : m_settings{settings}, m_types{std::move(types)}, m_nodes{std::move(nodes)}, m_root{root} {
+
+    compile_shapes();
+}
+
+template <typename Node>
+auto Validator<Node>::builtin_validators() -> const std::map<std::string, TypeValidator> & {
+    // todo: add built-in generic types (list<T>, map<K;V>)
+    static const std::map<std::string, TypeValidator> validators = {
+        // basic
+        {"any", impl::node_is_any},
+        {"map", NodeAccessor::is_map},
+        {"list", NodeAccessor::is_sequence},
+        {"scalar", NodeAccessor::is_scalar},
+
+        // numeric
+        {"numeric", impl::node_is_number},
+        {"num", impl::node_is_number},
+
+        // integer
+        {"integer", impl::node_is_integer},
+        {"int", impl::node_is_integer},
+
+        // bool
+        {"boolean", impl::node_is_boolean},
+        {"bool", impl::node_is_boolean},
+
+        // string
+        {"string", impl::node_is_string},
+        {"str", impl::node_is_string},
+    };
+
+    return validators;
+}
+
+template <typename Node>
+auto Validator<Node>::validate(const Node &doc, const ValidationOptions &options) const
+    -> std::vector<Error> {
+
+    const SchemaNode &root = m_nodes[m_root];
+    State state{
+        .options = options, .children_buffers = {}, .valid_nodes = {}, .stats = options.stats};
+    ErrorCounter error_counter{options.max_error_count};
+    const Context ctx{root.expected, state, error_counter};
+    std::vector<Error> errors;
+    validate(doc, root, ctx, errors);
+    return errors;
+}
+
+template <typename Node>
+auto Validator<Node>::is_valid(const Node &doc, const ValidationOptions &options) const -> bool {
+    const SchemaNode &root = m_nodes[m_root];
+    State state{
+        .options = options, .children_buffers = {}, .valid_nodes = {}, .stats = options.stats};
+    ErrorCounter error_counter{1};
+    const Context ctx = Context{root.expected, state, error_counter}.with_check_only();
+    std::vector<Error> errors; // stays empty, errors are only counted
+    validate(doc, root, ctx, errors);
+    return !error_counter.has_errors();
+}
+
+template <typename Node>
+auto Validator<Node>::revalidate(const Node &doc, const std::vector<Error> &errors,
+                                 std::span<const std::string> changed_paths,
+                                 const ValidationOptions &options) const -> std::vector<Error> {
+
+    std::vector<std::string> paths{changed_paths.begin(), changed_paths.end()};
+
+    while (true) {
+        const Revalidation revalidation{errors, paths};
+
+        // whole document is changed
+        if (revalidation.changed_paths.contains("/")) {
+            return validate(doc, options);
+        }
+
+        const SchemaNode &root = m_nodes[m_root];
+        State state{
+            .options = options, .children_buffers = {}, .valid_nodes = {}, .stats = options.stats};
+        ErrorCounter error_counter{options.max_error_count};
+        Context ctx{root.expected, state, error_counter};
+        ctx.revalidation = &revalidation;
+
+        std::vector<Error> result;
+        validate(doc, root, ctx, result);
+
+        if (revalidation.repeated_paths.empty()) {
+            return result;
+        }
+
+        // nodes reached more than once are validated again, each time adds at least one path
+        paths.insert(paths.end(), revalidation.repeated_paths.begin(),
+                     revalidation.repeated_paths.end());
+    }
+}
+
+template <typename Node>
+auto Validator<Node>::validate_batch(std::span<const Node> docs,
+                                     const ValidationOptions &options) const
+    -> std::vector<std::vector<Error>> {
+
+    const SchemaNode &root = m_nodes[m_root];
+    std::vector<std::vector<Error>> errors(docs.size());
+
+    const auto validate_range = [&](std::size_t begin, std::size_t end,
+                                    ValidationStats *stats) -> void {
+        State state{.options = options, .children_buffers = {}, .valid_nodes = {}, .stats = stats};
+
+        for (std::size_t i = begin; i < end; ++i) {
+            state.valid_nodes.clear();
+
+            ErrorCounter error_counter{options.max_error_count};
+            const Context ctx{root.expected, state, error_counter};
+            validate(docs[i], root, ctx, errors[i]);
+        }
+    };
+
+    Executor *executor = options.executor;
+
+    if (executor == nullptr || executor->concurrency() <= 1) {
+        validate_range(0, docs.size(), options.stats);
+        return errors;
+    }
+
+    // documents may differ in size, so use more chunks than for the children of a single node
+    const std::size_t chunk_count = std::min(docs.size(), executor->concurrency() * 16);
+    std::vector<ValidationStats> chunk_stats(options.stats != nullptr ? chunk_count : 0);
+
+    executor->run(chunk_count, [&](std::size_t chunk) -> void {
+        validate_range(docs.size() * chunk / chunk_count, docs.size() * (chunk + 1) / chunk_count,
+                       chunk_stats.empty() ? nullptr : &chunk_stats[chunk]);
+    });
+
+    for (const ValidationStats &stats : chunk_stats) {
+        options.stats->merge(stats);
+    }
+
+    return errors;
+}
+
+template <typename Node> auto Validator<Node>::serialize() const -> std::string {
+    impl::BinaryWriter writer;
+
+    // nodes are written as the strings they are rendered to
+    const auto write_expected = [&](const Expected &expected) -> void {
+        writer.write_bool(!std::holds_alternative<std::monostate>(expected));
+        writer.write_string(impl::dump_expected(expected));
+    };
+
+    writer.write_string(impl::binary_schema_magic);
+    writer.write_uint(impl::binary_schema_version);
+
+    writer.write_bool(m_settings.default_required);
+    writer.write_string(m_settings.optional_tag);
+    writer.write_string(m_settings.required_tag);
+    writer.write_string(m_settings.embed_tag);
+    writer.write_string(m_settings.variant_tag);
+    writer.write_string(m_settings.key_type_prefix);
+    writer.write_string(m_settings.generic_brackets);
+    writer.write_string(m_settings.generic_separator);
+    writer.write_string(m_settings.attribute_separator);
+    writer.write_bool(m_settings.ignore_attributes);
+
+    writer.write_uint(m_types.size());
+    for (const Type &type : m_types) {
+        // built-in and custom validators are found by the name
+        writer.write_string(type.name);
+        writer.write_bool(type.validator != nullptr);
+        writer.write_uint(type.node);
+    }
+
+    writer.write_uint(m_nodes.size());
+    for (const SchemaNode &node : m_nodes) {
+        writer.write_uint(static_cast<std::uint64_t>(node.kind));
+        write_expected(node.expected);
+        writer.write_uint(node.type);
+
+        writer.write_uint(node.children.size());
+        for (const SchemaNodeId child : node.children) {
+            writer.write_uint(child);
+        }
+
+        // values are compared without nodes, see impl::values_contain
+        std::vector<std::string> value_scalars = node.value_scalars;
+        std::vector<std::string> value_dumps = node.value_dumps;
+
+        for (const Node &value : node.values) {
+            if (NodeAccessor::is_scalar(value) && NodeAccessor::tag(value).empty()) {
+                value_scalars.push_back(NodeAccessor::template as<std::string>(value));
+            } else {
+                value_dumps.push_back(NodeAccessor::dump(value));
+            }
+        }
+
+        std::sort(value_scalars.begin(), value_scalars.end());
+
+        writer.write_uint(value_scalars.size());
+        for (const std::string &value : value_scalars) {
+            writer.write_string(value);
+        }
+
+        writer.write_uint(value_dumps.size());
+        for (const std::string &value : value_dumps) {
+            writer.write_string(value);
+        }
+
+        writer.write_uint(node.fields.size());
+        for (const MapField &field : node.fields) {
+            writer.write_string(field.key);
+            writer.write_uint(field.node);
+            writer.write_bool(field.is_required);
+            writer.write_bool(field.is_embed);
+        }
+
+        writer.write_uint(node.key_types.size());
+        for (const MapKeyType &key_type : node.key_types) {
+            write_expected(key_type.name);
+            writer.write_uint(key_type.type);
+            writer.write_uint(key_type.node);
+            writer.write_bool(key_type.is_required);
+        }
+
+        writer.write_bool(node.has_required_fields);
+    }
+
+    writer.write_uint(m_root);
+    return std::move(writer).data();
+}
+
+template <typename Node>
+auto Validator<Node>::deserialize(std::string_view blob,
+                                  const std::map<std::string, TypeValidator> &type_validators)
+    -> std::optional<Validator> {
+
+    impl::BinaryReader reader{blob};
+
+    if (reader.read_string() != impl::binary_schema_magic ||
+        reader.read_uint() != impl::binary_schema_version) {
+        return std::nullopt;
+    }
+
+    const auto read_expected = [&]() -> Expected {
+        const bool has_value = reader.read_bool();
+        std::string expected = reader.read_string();
+        return has_value ? Expected{std::move(expected)} : Expected{};
+    };
+
+    SchemaSettings settings{};
+    settings.default_required = reader.read_bool();
+    settings.optional_tag = reader.read_string();
+    settings.required_tag = reader.read_string();
+    settings.embed_tag = reader.read_string();
+    settings.variant_tag = reader.read_string();
+    settings.key_type_prefix = reader.read_string();
+    settings.generic_brackets = reader.read_string();
+    settings.generic_separator = reader.read_string();
+    settings.attribute_separator = reader.read_string();
+    settings.ignore_attributes = reader.read_bool();
+
+    if (!settings_are_valid(settings)) {
+        return std::nullopt;
+    }
+
+    // validators are set after the whole blob is checked
+    std::vector<Type> types(reader.read_count());
+    std::vector<char> type_has_validator(types.size());
+
+    for (std::size_t i = 0; i < types.size(); ++i) {
+        types[i].name = reader.read_string();
+        types[i].validator = nullptr;
+        type_has_validator[i] = reader.read_bool();
+        types[i].node = reader.read_uint();
+    }
+
+    std::vector<SchemaNode> nodes(reader.read_count());
+    for (SchemaNode &node : nodes) {
+        const std::uint64_t kind = reader.read_uint();
+        node.kind = kind <= static_cast<std::uint64_t>(SchemaNodeKind::Map)
+                        ? static_cast<SchemaNodeKind>(kind)
+                        : SchemaNodeKind::Type;
+        node.expected = read_expected();
+        node.type = reader.read_uint();
+
+        node.children.resize(reader.read_count());
+        for (SchemaNodeId &child : node.children) {
+            child = reader.read_uint();
+        }
+
+        node.value_scalars.resize(reader.read_count());
+        for (std::string &value : node.value_scalars) {
+            value = reader.read_string();
+        }
+
+        node.value_dumps.resize(reader.read_count());
+        for (std::string &value : node.value_dumps) {
+            value = reader.read_string();
+        }
+
+        node.fields.resize(reader.read_count());
+        for (std::size_t i = 0; i < node.fields.size(); ++i) {
+            MapField &field = node.fields[i];
+            field.key = reader.read_string();
+            field.node = reader.read_uint();
+            field.is_required = reader.read_bool();
+            field.is_embed = reader.read_bool();
+
+            if (!field.is_embed) {
+                node.field_indices.emplace(field.key, i);
+            }
+        }
+
+        node.key_types.resize(reader.read_count());
+        for (MapKeyType &key_type : node.key_types) {
+            key_type.name = read_expected();
+            key_type.type = reader.read_uint();
+            key_type.node = reader.read_uint();
+            key_type.is_required = reader.read_bool();
+        }
+
+        node.has_required_fields = reader.read_bool();
+
+        if (kind > static_cast<std::uint64_t>(SchemaNodeKind::Map) || reader.is_failed()) {
+            return std::nullopt;
+        }
+    }
+
+    const SchemaNodeId root = reader.read_uint();
+
+    if (!reader.is_finished() || root >= nodes.size()) {
+        return std::nullopt;
+    }
+
+    // references of a corrupted blob must not point out of the compiled schema
+    const auto node_is_valid = [&](const SchemaNode &node) -> bool {
+        const auto id_is_valid = [&](SchemaNodeId id) -> bool { return id < nodes.size(); };
+
+        switch (node.kind) {
+        case SchemaNodeKind::Type:
+            return node.type < types.size();
+        case SchemaNodeKind::Sequence:
+            return node.children.size() == 1 && id_is_valid(node.children[0]);
+        case SchemaNodeKind::ValueVariant:
+            return !node.value_scalars.empty() || !node.value_dumps.empty();
+        case SchemaNodeKind::TypeVariant:
+            return node.children.size() > 1 &&
+                   std::all_of(node.children.begin(), node.children.end(), id_is_valid);
+        case SchemaNodeKind::Map:
+            return std::all_of(node.fields.begin(), node.fields.end(),
+                               [&](const MapField &field) -> bool {
+                                   return id_is_valid(field.node);
+                               }) &&
+                   std::all_of(node.key_types.begin(), node.key_types.end(),
+                               [&](const MapKeyType &key_type) -> bool {
+                                   return key_type.type < types.size() &&
+                                          id_is_valid(key_type.node);
+                               });
+        case SchemaNodeKind::AnySequence:
+        case SchemaNodeKind::AnyMap:
+            break;
+        }
+
+        return true;
+    };
+
+    if (!std::all_of(nodes.begin(), nodes.end(), node_is_valid)) {
+        return std::nullopt;
+    }
+
+    for (std::size_t i = 0; i < types.size(); ++i) {
+        Type &type = types[i];
+
+        if (!type_has_validator[i]) {
+            if (type.node >= nodes.size()) {
+                return std::nullopt;
+            }
+
+            continue;
+        }
+
+        // custom validators take precedence over the built-in ones, as in the constructor
+        const auto custom_it = type_validators.find(type.name);
+        const auto builtin_it = builtin_validators().find(type.name);
+
+        if (custom_it != type_validators.end()) {
+            type.validator = custom_it->second;
+        } else if (builtin_it != builtin_validators().end()) {
+            type.validator = builtin_it->second;
+        } else {
+            // the blob names a custom type which validator isn't passed
+            return std::nullopt;
+        }
+    }
+
+    return Validator{settings, std::move(types), std::move(nodes), root};
+}
+
+template <typename Node>
+auto Validator<Node>::schema_settings(const Node &schema) -> SchemaSettings {
+    SchemaSettings settings{
+        .default_required = true,
+        .optional_tag = "optional",
+        .required_tag = "required",
+        .embed_tag = "embed",
+        .variant_tag = "variant",
+        .key_type_prefix = "$",
+        .generic_brackets = "<>",
+        .generic_separator = ";",
+        .attribute_separator = ":",
+        .ignore_attributes = false,
+    };
+
+    const Node settings_node = NodeAccessor::at(schema, "settings");
+
+    if (NodeAccessor::is_defined(settings_node)) {
+        settings.default_required = NodeAccessor::as(
+            NodeAccessor::at(settings_node, "default_required"), settings.default_required);
+        settings.optional_tag = NodeAccessor::as(NodeAccessor::at(settings_node, "optional_tag"),
+                                                 settings.optional_tag);
+        settings.required_tag = NodeAccessor::as(NodeAccessor::at(settings_node, "required_tag"),
+                                                 settings.required_tag);
+        settings.embed_tag =
+            NodeAccessor::as(NodeAccessor::at(settings_node, "embed_tag"), settings.embed_tag);
+        settings.variant_tag =
+            NodeAccessor::as(NodeAccessor::at(settings_node, "variant_tag"), settings.variant_tag);
+        settings.key_type_prefix = NodeAccessor::as(
+            NodeAccessor::at(settings_node, "key_type_prefix"), settings.key_type_prefix);
+        settings.generic_brackets = NodeAccessor::as(
+            NodeAccessor::at(settings_node, "generic_brackets"), settings.generic_brackets);
+        settings.generic_separator = NodeAccessor::as(
+            NodeAccessor::at(settings_node, "generic_separator"), settings.generic_separator);
+        settings.attribute_separator = NodeAccessor::as(
+            NodeAccessor::at(settings_node, "attribute_separator"), settings.attribute_separator);
+        settings.ignore_attributes = NodeAccessor::as(
+            NodeAccessor::at(settings_node, "ignore_attributes"), settings.ignore_attributes);
+    }
+
+    MIROIR_ASSERT(!settings.optional_tag.empty(), "optional tag name is empty");
+    MIROIR_ASSERT(!settings.required_tag.empty(), "required tag name is empty");
+    MIROIR_ASSERT(!settings.embed_tag.empty(), "embed tag name is empty");
+    MIROIR_ASSERT(!settings.variant_tag.empty(), "variant tag name is empty");
+    MIROIR_ASSERT(!settings.key_type_prefix.empty(), "key type prefix is empty");
+
+    MIROIR_ASSERT(settings.generic_brackets.size() == 2,
+                  "invalid generic brackets string length: " << settings.generic_brackets);
+    MIROIR_ASSERT(settings.generic_separator.size() == 1,
+                  "invalid generic separator string length: " << settings.generic_separator);
+
+    MIROIR_ASSERT(settings.attribute_separator.size() == 1,
+                  "invalid attribute separator string length: " << settings.attribute_separator);
+
+    return settings;
+}
+
+template <typename Node>
+auto Validator<Node>::settings_are_valid(const SchemaSettings &settings) -> bool {
+    return !settings.optional_tag.empty() && !settings.required_tag.empty() &&
+           !settings.embed_tag.empty() && !settings.variant_tag.empty() &&
+           !settings.key_type_prefix.empty() && settings.generic_brackets.size() == 2 &&
+           settings.generic_separator.size() == 1 && settings.attribute_separator.size() == 1;
+}
+
+template <typename Node>
+auto Validator<Node>::schema_types(const Node &schema) -> std::map<std::string, Node> {
+    return NodeAccessor::as(NodeAccessor::at(schema, "types"), std::map<std::string, Node>{});
+}
+
+template <typename Node> auto Validator<Node>::schema_root(const Node &schema) -> Node {
+    MIROIR_ASSERT(NodeAccessor::is_map(schema),
+                  "schema is not a map: " << NodeAccessor::dump(schema));
+    const Node root = NodeAccessor::at(schema, "root");
+    MIROIR_ASSERT(NodeAccessor::is_defined(root), "missing root node in the schema");
+    return root;
+}
+
+template <typename Node>
+auto Validator<Node>::generic_schema_types(const std::map<std::string, Node> &types) const
+    -> std::map<std::string, GenericSchemaType> {
+
+    std::map<std::string, GenericSchemaType> generic_types;
+
+    for (const auto &[schema_type, schema_type_node] : types) {
+        if (!type_is_generic(schema_type)) {
+            continue;
+        }
+
+        GenericType generic_type = parse_generic_type(schema_type);
+        const std::string name = generic_type.name;
+
+        // the first type in the schema order is used if there are few types with the same name
+        generic_types.emplace(name, GenericSchemaType{
+                                        .type = std::move(generic_type),
+                                        .node = schema_type_node,
+                                    });
+    }
+
+    return generic_types;
+}
+
+template <typename Node>
+auto Validator<Node>::compile(const Node &schema, const std::map<std::string, std::string> &where,
+                              CompileContext &cc) -> SchemaNodeId {
+
+    SchemaNode node{
+        .kind = SchemaNodeKind::Type,
+        .expected = schema,
+        .type = 0,
+        .children = {},
+        .shapes = {},
+        .values = {},
+        .value_indices = {},
+        .value_scalars = {},
+        .value_dumps = {},
+        .fields = {},
+        .field_indices = {},
+        .key_types = {},
+        .has_required_fields = false,
+    };
+
+    if (NodeAccessor::is_scalar(schema)) {
+        const std::string type = NodeAccessor::template as<std::string>(schema);
+        const auto concrete_type_it = where.find(type);
+
+        // errors of the generic arg are reported with the name of the concrete type
+        node.expected = concrete_type_it != where.end() ? concrete_type_it->second : type;
+        node.type = compile_type(type, where, cc);
+    } else if (NodeAccessor::is_sequence(schema)) {
+        compile_sequence(schema, where, cc, node);
+    } else if (NodeAccessor::is_map(schema)) {
+        compile_map(schema, where, cc, node);
+    } else {
+        MIROIR_ASSERT(false, "invalid schema node: " << NodeAccessor::dump(schema));
+        node.type = make_type("", impl::node_is_any, cc);
+    }
+
+    m_nodes.push_back(node);
+    return m_nodes.size() - 1;
+}
+
+template <typename Node>
+auto Validator<Node>::compile_type(const std::string &type,
+                                   const std::map<std::string, std::string> &where,
+                                   CompileContext &cc) -> TypeId {
+
+    // generic args
+    // note: generic args can only contain names of other types, but not the types themselves, e.g.
+    // "generic<string>" is a valid type, but "generic<[string]>" is not, define and use an alias
+    // (e.g. "list<string>")
+    const auto concrete_type_it = where.find(type);
+    if (concrete_type_it != where.end()) {
+        const std::string &concrete_type = concrete_type_it->second;
+        return compile_type(concrete_type, {}, cc);
+    }
+
+    // generic types
+    if (type_is_generic(type)) {
+        const GenericType generic_type = parse_generic_type(type);
+        const auto generic_schema_type_it = cc.generic_types.find(generic_type.name);
+
+        if (generic_schema_type_it != cc.generic_types.end()) {
+            const auto &[generic_schema_type, schema_type_node] = generic_schema_type_it->second;
+
+            // every distinct set of generic args is compiled into a separate type
+            const std::string name = concrete_type(type, where);
+            const auto type_id_it = cc.type_ids.find(name);
+            if (type_id_it != cc.type_ids.end()) {
+                return type_id_it->second;
+            }
+
+            // note: generic types recursively instantiated with growing args (e.g. "rec<T>:
+            // [rec<list<T>>]") can't be compiled
+            MIROIR_ASSERT(cc.generic_depth < 256, "generic type is too deep: " << name);
+
+            const std::map<std::string, std::string> generic_args =
+                make_generic_args(generic_schema_type, generic_type, where);
+            const TypeId type_id = make_type(name, nullptr, cc);
+
+            ++cc.generic_depth;
+            const SchemaNodeId node = compile(schema_type_node, generic_args, cc);
+            --cc.generic_depth;
+
+            m_types[type_id].node = node;
+            return type_id;
+        }
+    }
+
+    const auto type_id_it = cc.type_ids.find(type);
+    if (type_id_it != cc.type_ids.end()) {
+        return type_id_it->second;
+    }
+
+    // schema types
+    const auto schema_type_it = cc.types.find(type);
+    if (schema_type_it != cc.types.end()) {
+        const TypeId type_id = make_type(type, nullptr, cc);
+        const SchemaNodeId node = compile(schema_type_it->second, {}, cc);
+        m_types[type_id].node = node;
+        return type_id;
+    }
+
+    // built-in types
+    const auto validator_it = cc.validators.find(type);
+    if (validator_it != cc.validators.end()) {
+        return make_type(type, validator_it->second, cc);
+    }
+
+    MIROIR_ASSERT(false, "type not found: " << type);
+    return make_type(type, impl::node_is_any, cc);
+}
+
+template <typename Node>
+void Validator<Node>::compile_sequence(const Node &schema,
+                                       const std::map<std::string, std::string> &where,
+                                       CompileContext &cc, SchemaNode &node) {
+
+    const std::size_t schema_size = NodeAccessor::size(schema);
+
+    if (schema_size == 0) {
+        node.kind = SchemaNodeKind::AnySequence;
+    } else if (tag_is_variant(NodeAccessor::tag(schema))) {
+        node.kind = SchemaNodeKind::ValueVariant;
+
+        for (auto it = NodeAccessor::begin(schema); it != NodeAccessor::end(schema); ++it) {
+            if constexpr (requires { NodeAccessor::hash(*it); }) {
+                node.value_indices.emplace(NodeAccessor::hash(*it), node.values.size());
+            }
+
+            node.values.push_back(*it);
+        }
+    } else {
+        node.kind = schema_size == 1 ? SchemaNodeKind::Sequence : SchemaNodeKind::TypeVariant;
+
+        for (auto it = NodeAccessor::begin(schema); it != NodeAccessor::end(schema); ++it) {
+            node.children.push_back(compile(*it, where, cc));
+        }
+    }
+}
+
+template <typename Node>
+void Validator<Node>::compile_map(const Node &schema,
+                                  const std::map<std::string, std::string> &where,
+                                  CompileContext &cc, SchemaNode &node) {
+
+    if (NodeAccessor::size(schema) == 0) {
+        node.kind = SchemaNodeKind::AnyMap;
+        return;
+    }
+
+    node.kind = SchemaNodeKind::Map;
+
+    for (auto it = NodeAccessor::begin(schema); it != NodeAccessor::end(schema); ++it) {
+        const Node schema_val_node = it->second;
+        const std::string schema_val_tag = NodeAccessor::tag(schema_val_node);
+
+        if (tag_is_embed(schema_val_tag)) {
+            node.fields.push_back(MapField{
+                .key = "",
+                .node = compile(schema_val_node, where, cc),
+                .is_required = false,
+                .is_embed = true,
+            });
+        } else {
+            const Node schema_key_node = it->first;
+            const std::string key = NodeAccessor::template as<std::string>(schema_key_node);
+            const bool node_is_required = tag_is_required(schema_val_tag);
+
+            if (!impl::string_is_prefixed(key, m_settings.key_type_prefix)) {
+                node.field_indices.emplace(key, node.fields.size());
+                node.fields.push_back(MapField{
+                    .key = key,
+                    .node = compile(schema_val_node, where, cc),
+                    .is_required = node_is_required,
+                    .is_embed = false,
+                });
+
+                node.has_required_fields = node.has_required_fields || node_is_required;
+            } else {
+                const std::string key_type = key.substr(m_settings.key_type_prefix.size());
+
+                node.key_types.push_back(MapKeyType{
+                    .name = key_type,
+                    .type = compile_type(key_type, where, cc),
+                    .node = compile(schema_val_node, where, cc),
+                    .is_required = node_is_required,
+                });
+            }
+        }
+    }
+}
+
+template <typename Node>
+auto Validator<Node>::make_type(const std::string &name, TypeValidator validator,
+                                CompileContext &cc) -> TypeId {
+
+    m_types.push_back(Type{
+        .name = name,
+        .validator = validator,
+        .node = 0,
+    });
+
+    const TypeId type_id = m_types.size() - 1;
+    cc.type_ids[name] = type_id;
+    return type_id;
+}
+
+template <typename Node> void Validator<Node>::compile_shapes() {
+    for (SchemaNode &node : m_nodes) {
+        if (node.kind != SchemaNodeKind::TypeVariant) {
+            continue;
+        }
+
+        for (const SchemaNodeId child : node.children) {
+            node.shapes.push_back(compile_shape(child));
+        }
+    }
+}
+
+template <typename Node>
+auto Validator<Node>::compile_shape(SchemaNodeId node_id) const -> Shape {
+    const SchemaNode &node = m_nodes[resolve_node(node_id)];
+    Shape shape{.kind = ShapeKind::Any, .fields = {}};
+
+    switch (node.kind) {
+    case SchemaNodeKind::AnySequence:
+    case SchemaNodeKind::Sequence:
+        shape.kind = ShapeKind::Sequence;
+        break;
+    case SchemaNodeKind::AnyMap:
+        shape.kind = ShapeKind::Map;
+        break;
+    case SchemaNodeKind::Map:
+        shape.kind = ShapeKind::Map;
+
+        for (const MapField &field : node.fields) {
+            if (!field.is_required) {
+                continue;
+            }
+
+            // tag-like fields (e.g. `kind: !variant [circle]`) discriminate the variants by value
+            const SchemaNodeId value_id = resolve_node(field.node);
+            const bool is_value_variant = m_nodes[value_id].kind == SchemaNodeKind::ValueVariant;
+
+            shape.fields.push_back(ShapeField{
+                .key = field.key,
+                .values = is_value_variant ? value_id : npos,
+            });
+        }
+        break;
+    case SchemaNodeKind::Type:
+    case SchemaNodeKind::ValueVariant:
+    case SchemaNodeKind::TypeVariant:
+        // built-in types and value variants are cheap to validate, nested variants are validated
+        break;
+    }
+
+    return shape;
+}
+
+template <typename Node>
+auto Validator<Node>::resolve_node(SchemaNodeId node_id) const -> SchemaNodeId {
+    // steps are limited in case of the types referencing each other
+    for (std::size_t i = 0; i < m_types.size(); ++i) {
+        const SchemaNode &node = m_nodes[node_id];
+
+        if (node.kind != SchemaNodeKind::Type || m_types[node.type].validator != nullptr) {
+            break;
+        }
+
+        node_id = m_types[node.type].node;
+    }
+
+    return node_id;
+}
+
+template <typename Node>
+void Validator<Node>::add_error(ErrorType type, const Context &ctx, std::vector<Error> &errors,
+                                std::vector<std::vector<Error>> &&variant_errors) {
+
+    if (!ctx.error_counter->try_add() || ctx.is_check_only) {
+        return;
+    }
+
+    std::string path;
+    ctx.path.render(path);
+
+    errors.push_back(Error{
+        .type = type,
+        .path = std::move(path),
+        .expected = *ctx.expected,
+        .variant_errors = std::move(variant_errors),
+    });
+}
+
+template <typename Node>
+void Validator<Node>::validate(const Node &doc, const SchemaNode &schema, const Context &ctx,
+                               std::vector<Error> &errors) const {
+
+    if (ctx.is_stopped()) {
+        return;
+    }
+
+    if (ctx.revalidation != nullptr && revalidate(doc, schema, ctx, errors)) {
+        return;
+    }
+
+    // references to the types are counted by the type dispatches
+    if (ctx.state->stats != nullptr && schema.kind != SchemaNodeKind::Type) {
+        ++ctx.state->stats->node_count;
+    }
+
+    switch (schema.kind) {
+    case SchemaNodeKind::Type:
+        validate_type(doc, schema, ctx, errors);
+        return;
+    case SchemaNodeKind::AnySequence:
+    case SchemaNodeKind::Sequence:
+    case SchemaNodeKind::ValueVariant:
+    case SchemaNodeKind::TypeVariant:
+        validate_sequence(doc, schema, ctx, errors);
+        return;
+    case SchemaNodeKind::AnyMap:
+    case SchemaNodeKind::Map:
+        validate_map(doc, schema, ctx, errors);
+        return;
+    }
+
+    MIROIR_ASSERT(false, "invalid schema node kind: " << static_cast<int>(schema.kind));
+}
+
+template <typename Node>
+auto Validator<Node>::revalidate(const Node &doc, const SchemaNode &schema, const Context &ctx,
+                                 std::vector<Error> &errors) const -> bool {
+
+    // embedded nodes have the path of the parent map, which is validated again anyway
+    if (ctx.is_check_only || ctx.embed_claims != nullptr) {
+        return false;
+    }
+
+    using Change = typename Revalidation::Change;
+
+    // keys which aren't scalars can't be written in the paths, so their nodes are validated again
+    Change change = Change::Subtree;
+    std::string path;
+
+    if (ctx.path.kind != PathSegmentKind::KeyNode || NodeAccessor::is_scalar(*ctx.path.key_node)) {
+        ctx.path.render(path);
+        change = ctx.revalidation->find_change(path);
+    }
+
+    switch (change) {
+    case Change::None:
+        break;
+    case Change::Descendants:
+        return false;
+    case Change::Subtree: {
+        // whole subtree is validated again
+        Context changed_ctx = ctx;
+        changed_ctx.revalidation = nullptr;
+        validate(doc, schema, changed_ctx, errors);
+        return true;
+    }
+    }
+
+    const auto range_it = ctx.revalidation->error_ranges.find(path);
+
+    if (range_it == ctx.revalidation->error_ranges.end()) {
+        // node was valid
+        return true;
+    }
+
+    if (!ctx.revalidation->reuse(path)) {
+        // errors are already reused, the node is validated again on the next pass
+        return true;
+    }
+
+    for (std::size_t i = range_it->second.first; i < range_it->second.second; ++i) {
+        if (!ctx.error_counter->try_add()) {
+            break;
+        }
+
+        Error &error = errors.emplace_back(ctx.revalidation->errors[i]);
+
+        // previous errors of the variants are unlimited
+        if (ctx.state->options.max_error_count != 0) {
+            impl::limit_variant_errors(error, ctx.state->options.max_error_count);
+        }
+    }
+
+    return true;
+}
+
+template <typename Node>
+void Validator<Node>::validate_type(const Node &doc, const SchemaNode &schema, const Context &ctx,
+                                    std::vector<Error> &errors) const {
+
+    const Type &type = m_types[schema.type];
+    const Context type_ctx = ctx.with_expected(schema.expected);
+    const TypeDispatch dispatch{ctx.state->stats, type.name};
+
+    // built-in types
+    if (type.validator != nullptr) {
+        if (ctx.state->stats != nullptr) {
+            ++ctx.state->stats->node_count;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            // embedded node is not a map
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!type.validator(doc)) {
+            // node has invalid type
+            add_error(ErrorType::InvalidValueType, type_ctx, errors);
+        }
+
+        return;
+    }
+
+    // schema types
+    validate_memoized(doc, schema.type, type_ctx, errors);
+}
+
+template <typename Node>
+auto Validator<Node>::validate_type(const Node &doc, TypeId type_id, const Context &ctx) const
+    -> bool {
+
+    const Type &type = m_types[type_id];
+    const TypeDispatch dispatch{ctx.state->stats, type.name};
+
+    if (type.validator != nullptr) {
+        return type.validator(doc);
+    }
+
+    // the first error is enough to reject the node
+    ErrorCounter error_counter{1};
+    Context type_ctx = ctx.with_error_counter(error_counter).with_check_only();
+    type_ctx.embed_claims = nullptr; // node is a key, not a part of the embedded map
+
+    std::vector<Error> errors;
+    validate_memoized(doc, type_id, type_ctx, errors);
+    return !error_counter.has_errors();
+}
+
+template <typename Node>
+void Validator<Node>::validate_memoized(const Node &doc, TypeId type_id, const Context &ctx,
+                                        std::vector<Error> &errors) const {
+
+    const SchemaNode &schema = m_nodes[m_types[type_id].node];
+    const void *identity = nullptr;
+
+    // embedded nodes claim children of the parent map, so they are always validated
+    if constexpr (requires { NodeAccessor::identity(doc); }) {
+        if (ctx.state->options.memoize && ctx.embed_claims == nullptr) {
+            identity = NodeAccessor::identity(doc);
+        }
+    }
+
+    if (identity == nullptr) {
+        validate(doc, schema, ctx, errors);
+        return;
+    }
+
+    std::unordered_set<MemoKey, MemoKeyHash> &valid_nodes = ctx.state->valid_nodes;
+    const MemoKey key{.node = identity, .type = type_id};
+
+    // node isn't validated after the stop, so it can't be memoized as valid
+    if (valid_nodes.contains(key) || ctx.is_stopped()) {
+        return;
+    }
+
+    // note: the counter can be shared with other threads, so the node may be not memoized even if
+    // it's valid, but never the opposite
+    const std::size_t error_count = ctx.error_counter->count.load(std::memory_order_relaxed);
+    validate(doc, schema, ctx, errors);
+
+    if (ctx.error_counter->count.load(std::memory_order_relaxed) == error_count) {
+        valid_nodes.insert(key);
+    }
+}
+
+template <typename Node>
+void Validator<Node>::validate_sequence(const Node &doc, const SchemaNode &schema,
+                                        const Context &ctx, std::vector<Error> &errors) const {
+
+    if (ctx.embed_claims != nullptr && schema.kind != SchemaNodeKind::TypeVariant) {
+        // embedded node is not a map
+        ctx.embed_claims->is_all = true;
+    }
+
+    if (schema.kind == SchemaNodeKind::AnySequence) {
+        if (!NodeAccessor::is_sequence(doc)) {
+            // schema node is an empty sequence but document node is not a sequence
+            add_error(ErrorType::InvalidValueType, ctx, errors);
+        }
+
+        // allow any sequence on empty sequence in the schema
+        return;
+    }
+
+    if (schema.kind == SchemaNodeKind::ValueVariant) {
+        if (!variant_contains(schema, doc)) {
+            // document node has invalid value
+            add_error(ErrorType::InvalidValue, ctx, errors);
+        }
+    } else if (schema.kind == SchemaNodeKind::Sequence) {
+        const SchemaNode &child_schema_node = m_nodes[schema.children[0]];
+
+        // items of a built-in type (e.g. `[integer]`) are checked in a tight loop, the context of
+        // the item is made only for the error, the stats are collected by validate_type
+        const TypeValidator child_validator =
+            child_schema_node.kind == SchemaNodeKind::Type && ctx.state->stats == nullptr
+                ? m_types[child_schema_node.type].validator
+                : nullptr;
+
+        if (NodeAccessor::is_sequence(doc)) {
+            validate_chunks(NodeAccessor::size(doc), ctx, errors,
+                            [&](std::size_t begin, std::size_t end, const Context &chunk_ctx,
+                                std::vector<Error> &chunk_errors) -> void {
+                                for (std::size_t i = begin; i < end && !chunk_ctx.is_stopped();
+                                     ++i) {
+                                    const Node child_doc_node = NodeAccessor::at(doc, i);
+
+                                    if (child_validator == nullptr) {
+                                        validate(child_doc_node, child_schema_node,
+                                                 chunk_ctx.appending_index(i), chunk_errors);
+                                    } else if (!child_validator(child_doc_node)) {
+                                        // item has invalid type
+                                        add_error(ErrorType::InvalidValueType,
+                                                  chunk_ctx.appending_index(i).with_expected(
+                                                      child_schema_node.expected),
+                                                  chunk_errors);
+                                    }
+                                }
+                            });
+        } else {
+            // schema node is a sequence but document node is not a sequence
+            add_error(ErrorType::InvalidValueType, ctx, errors);
+        }
+    } else { // SchemaNodeKind::TypeVariant
+        // validates the variant, returns true if the document node is valid
+        const auto validate_variant = [&](std::size_t variant_index,
+                                          std::vector<Error> &variant_errors) -> bool {
+            const SchemaNode &variant_schema = m_nodes[schema.children[variant_index]];
+
+            // errors of the variant are limited separately, they aren't the resulting errors
+            const std::size_t variant_max_error_count =
+                ctx.is_check_only ? 1 : ctx.state->options.max_error_count;
+            ErrorCounter variant_error_counter{variant_max_error_count};
+            EmbedClaims variant_claims{.children = {}, .is_all = false};
+
+            Context variant_ctx = ctx.with_expected(variant_schema.expected)
+                                      .with_error_counter(variant_error_counter);
+
+            // errors of the alternatives aren't kept, so they are validated again as a whole
+            variant_ctx.revalidation = nullptr;
+
+            if (ctx.embed_claims != nullptr) {
+                variant_ctx = variant_ctx.with_embed(variant_claims);
+            }
+
+            validate(doc, variant_schema, variant_ctx, variant_errors);
+
+            if (ctx.state->stats != nullptr) {
+                ++ctx.state->stats->variant_attempt_count;
+                ctx.state->stats->variant_reject_count += variant_error_counter.has_errors();
+            }
+
+            if (variant_error_counter.has_errors()) {
+                return false;
+            }
+
+            if (ctx.embed_claims != nullptr) {
+                ctx.embed_claims->claim(variant_claims);
+            }
+
+            return true;
+        };
+
+        std::vector<std::vector<Error>> grouped_errors(schema.children.size());
+        bool has_skipped_variants = false;
+
+        for (std::size_t i = 0; i < schema.children.size(); ++i) {
+            if (!matches_shape(doc, schema.shapes[i])) {
+                // variant can't match the node, e.g. the node is a map with a wrong `kind` field
+                has_skipped_variants = true;
+
+                if (ctx.state->stats != nullptr) {
+                    ++ctx.state->stats->variant_skip_count;
+                }
+            } else if (validate_variant(i, grouped_errors[i])) {
+                // found correct node type
+                return;
+            }
+        }
+
+        if (has_skipped_variants && !ctx.is_check_only) {
+            // skipped variants are validated only to report their errors
+            for (std::size_t i = 0; i < schema.children.size(); ++i) {
+                if (!matches_shape(doc, schema.shapes[i])) {
+                    validate_variant(i, grouped_errors[i]);
+                }
+            }
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            // don't report nodes of the invalid embedded node as undefined
+            ctx.embed_claims->is_all = true;
+        }
+
+        // document node has invalid type
+        add_error(ErrorType::InvalidValueType, ctx, errors, std::move(grouped_errors));
+    }
+}
+
+template <typename Node>
+void Validator<Node>::validate_map(const Node &doc, const SchemaNode &schema, const Context &ctx,
+                                   std::vector<Error> &errors) const {
+
+    const bool doc_is_map = NodeAccessor::is_map(doc);
+
+    if (schema.kind == SchemaNodeKind::AnyMap) {
+        if (ctx.embed_claims != nullptr) {
+            // embedded any map claims all nodes
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!doc_is_map) {
+            // document node must be a map
+            add_error(ErrorType::InvalidValueType, ctx, errors);
+        }
+
+        // allow any map on empty map in the schema
+        return;
+    }
+
+    if (!doc_is_map) {
+        for (const MapField &field : schema.fields) {
+            if (!field.is_embed && field.is_required) {
+                // required node not found
+                add_error(ErrorType::NodeNotFound, ctx.appending_path(field.key), errors);
+            }
+        }
+
+        if (!schema.has_required_fields || !schema.key_types.empty()) {
+            // document node must be a map
+            add_error(ErrorType::InvalidValueType, ctx, errors);
+        }
+
+        return;
+    }
+
+    // children of the document node
+    std::vector<MapChild> children = ctx.state->acquire_children();
+    children.reserve(NodeAccessor::size(doc));
+
+    for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
+        children.push_back(MapChild{
+            .key = it->first,
+            .value = it->second,
+            .key_type = npos,
+            .is_validated = false,
+        });
+    }
+
+    const std::vector<std::size_t> field_children = find_fields(schema, children);
+
+    // children claimed by the embedded schema nodes, nested embeds claim children for the outer map
+    EmbedClaims claims{.children = {}, .is_all = false};
+    EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+
+    // validate document structure
+    for (std::size_t i = 0; i < schema.fields.size() && !ctx.is_stopped(); ++i) {
+        const MapField &field = schema.fields[i];
+        const SchemaNode &schema_val_node = m_nodes[field.node];
+
+        if (field.is_embed) {
+            validate(doc, schema_val_node, ctx.with_embed(embed_claims), errors);
+            continue;
+        }
+
+        const std::size_t child_index = field_children[i];
+        const Context child_ctx = ctx.appending_path(field.key);
+
+        if (child_index != npos) {
+            MapChild &child = children[child_index];
+            validate(child.value, schema_val_node, child_ctx, errors);
+            child.is_validated = true;
+        } else if (field.is_required) {
+            // required node not found
+            add_error(ErrorType::NodeNotFound, child_ctx, errors);
+        }
+    }
+
+    // match keys of the children with key types, each key is matched once in the schema order
+    if (!schema.key_types.empty() && !ctx.is_stopped()) {
+        validate_chunks(children.size(), ctx, errors,
+                        [&](std::size_t begin, std::size_t end, const Context &chunk_ctx,
+                            std::vector<Error> & /*chunk_errors*/) -> void {
+                            for (std::size_t i = begin; i < end; ++i) {
+                                MapChild &child = children[i];
+
+                                if (child.is_validated) {
+                                    continue;
+                                }
+
+                                for (std::size_t j = 0; j < schema.key_types.size(); ++j) {
+                                    if (chunk_ctx.state->stats != nullptr) {
+                                        ++chunk_ctx.state->stats->key_probe_count;
+                                    }
+
+                                    if (validate_type(child.key, schema.key_types[j].type,
+                                                      chunk_ctx)) {
+                                        child.key_type = j;
+                                        break;
+                                    }
+                                }
+                            }
+                        });
+    }
+
+    // validate key types
+    for (std::size_t i = 0; i < schema.key_types.size() && !ctx.is_stopped(); ++i) {
+        const MapKeyType &key_type = schema.key_types[i];
+        const SchemaNode &schema_val_node = m_nodes[key_type.node];
+        std::atomic<bool> key_type_is_found = false;
+
+        validate_chunks(children.size(), ctx, errors,
+                        [&](std::size_t begin, std::size_t end, const Context &chunk_ctx,
+                            std::vector<Error> &chunk_errors) -> void {
+                            for (std::size_t j = begin; j < end && !chunk_ctx.is_stopped(); ++j) {
+                                MapChild &child = children[j];
+
+                                if (child.key_type != i) {
+                                    continue;
+                                }
+
+                                validate(child.value, schema_val_node,
+                                         chunk_ctx.appending_key(child.key), chunk_errors);
+
+                                // note: each child is written by a single thread
+                                child.is_validated = true;
+                                key_type_is_found.store(true, std::memory_order_relaxed);
+                            }
+                        });
+
+        if (key_type.is_required && !key_type_is_found.load(std::memory_order_relaxed)) {
+            // didn't find a key with required type
+            add_error(ErrorType::MissingKeyWithType, ctx.with_expected(key_type.name), errors);
+        }
+    }
+
+    if (ctx.embed_claims != nullptr) {
+        // undefined nodes are found by the outer map
+        for (std::size_t i = 0; i < children.size(); ++i) {
+            if (children[i].is_validated) {
+                ctx.embed_claims->claim(i);
+            }
+        }
+    } else {
+        // find undefined nodes
+        for (std::size_t i = 0; i < children.size() && !ctx.is_stopped(); ++i) {
+            if (children[i].is_validated || claims.is_claimed(i)) {
+                continue;
+            }
+
+            // node not defined in the schema
+            add_error(ErrorType::UndefinedNode, ctx.appending_key(children[i].key), errors);
+        }
+    }
+
+    ctx.state->release_children(std::move(children));
+}
+
+template <typename Node>
+template <typename ValidateRange>
+void Validator<Node>::validate_chunks(std::size_t count, const Context &ctx,
+                                      std::vector<Error> &errors,
+                                      const ValidateRange &validate_range) const {
+
+    const ValidationOptions &options = ctx.state->options;
+    Executor *executor = options.executor;
+
+    if (executor == nullptr || executor->concurrency() <= 1 || count < options.parallel_threshold) {
+        validate_range(0, count, ctx, errors);
+        return;
+    }
+
+    // few chunks per thread to balance the load
+    const std::size_t chunk_count = std::min(count, executor->concurrency() * 4);
+    std::vector<std::vector<Error>> chunk_errors(chunk_count);
+    std::vector<ValidationStats> chunk_stats(ctx.state->stats != nullptr ? chunk_count : 0);
+
+    executor->run(chunk_count, [&](std::size_t chunk) -> void {
+        // state isn't shared between threads
+        State chunk_state{
+            .options = options,
+            .children_buffers = {},
+            .valid_nodes = {},
+            .stats = chunk_stats.empty() ? nullptr : &chunk_stats[chunk],
+        };
+
+        validate_range(count * chunk / chunk_count, count * (chunk + 1) / chunk_count,
+                       ctx.with_state(chunk_state), chunk_errors[chunk]);
+    });
+
+    for (const ValidationStats &stats : chunk_stats) {
+        ctx.state->stats->merge(stats);
+    }
+
+    for (std::vector<Error> &errs : chunk_errors) {
+        errors.insert(errors.end(), std::make_move_iterator(errs.begin()),
+                      std::make_move_iterator(errs.end()));
+    }
+}
+
+template <typename Node>
+auto Validator<Node>::tag_is_optional(const std::string &tag) const -> bool {
+    return tag == m_settings.optional_tag;
+}
+
+template <typename Node> auto Validator<Node>::tag_is_embed(const std::string &tag) const -> bool {
+    return tag == m_settings.embed_tag;
+}
+
+template <typename Node>
+auto Validator<Node>::tag_is_variant(const std::string &tag) const -> bool {
+    return tag == m_settings.variant_tag;
+}
+
+template <typename Node>
+auto Validator<Node>::tag_is_required(const std::string &tag) const -> bool {
+    return (m_settings.default_required && !tag_is_optional(tag)) ||
+           (!m_settings.default_required && tag == m_settings.required_tag);
+}
+
+template <typename Node>
+auto Validator<Node>::variant_contains(const SchemaNode &schema, const Node &doc) const -> bool {
+    // deserialized validators don't have the value nodes
+    if (schema.values.empty()) {
+        return impl::values_contain(doc, schema.value_scalars, schema.value_dumps);
+    }
+
+    if constexpr (requires { NodeAccessor::hash(doc); }) {
+        // only values with the same hash can be equal
+        const auto [begin, end] = schema.value_indices.equal_range(NodeAccessor::hash(doc));
+
+        for (auto it = begin; it != end; ++it) {
+            if (NodeAccessor::equals(doc, schema.values[it->second])) {
+                return true;
+            }
+        }
+    } else {
+        for (const Node &value : schema.values) {
+            if (NodeAccessor::equals(doc, value)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+template <typename Node>
+auto Validator<Node>::matches_shape(const Node &doc, const Shape &shape) const -> bool {
+    switch (shape.kind) {
+    case ShapeKind::Any:
+        return true;
+    case ShapeKind::Sequence:
+        return NodeAccessor::is_sequence(doc);
+    case ShapeKind::Map:
+        break;
+    }
+
+    if (!NodeAccessor::is_map(doc)) {
+        return false;
+    }
+
+    for (const ShapeField &field : shape.fields) {
+        const std::optional<Node> value = find_value(doc, field.key);
+
+        if (!value.has_value() ||
+            (field.values != npos && !variant_contains(m_nodes[field.values], *value))) {
+            // required node not found or has invalid value
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename Node>
+auto Validator<Node>::find_value(const Node &doc, const std::string &key) const
+    -> std::optional<Node> {
+
+    std::string buffer;
+
+    // exact key first, the first child is used if the keys are duplicated
+    for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
+        if (NodeAccessor::is_scalar(it->first) && impl::scalar_view(it->first, buffer) == key) {
+            return it->second;
+        }
+    }
+
+    if (!m_settings.ignore_attributes) {
+        return std::nullopt;
+    }
+
+    // then key with attributes
+    for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
+        if (NodeAccessor::is_scalar(it->first) &&
+            impl::string_trim_after(impl::scalar_view(it->first, buffer),
+                                    m_settings.attribute_separator[0]) == key) {
+            return it->second;
+        }
+    }
+
+    return std::nullopt;
+}
+
+template <typename Node>
+auto Validator<Node>::find_fields(const SchemaNode &schema,
+                                  const std::vector<MapChild> &children) const
+    -> std::vector<std::size_t> {
+
+    std::vector<std::size_t> field_children(schema.fields.size(), npos);
+    std::size_t found_count = 0;
+    std::string buffer;
+
+    // exact keys first, the first child is used if the keys are duplicated
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        if (!NodeAccessor::is_scalar(children[i].key)) {
+            continue;
+        }
+
+        const std::string_view key = impl::scalar_view(children[i].key, buffer);
+        const auto field_index_it = schema.field_indices.find(key);
+
+        if (field_index_it != schema.field_indices.end() &&
+            field_children[field_index_it->second] == npos) {
+            field_children[field_index_it->second] = i;
+            ++found_count;
+        }
+    }
+
+    if (!m_settings.ignore_attributes || found_count == schema.field_indices.size()) {
+        return field_children;
+    }
+
+    // then keys with attributes
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        if (!NodeAccessor::is_scalar(children[i].key)) {
+            continue;
+        }
+
+        const std::string_view key = impl::scalar_view(children[i].key, buffer);
+        const auto field_index_it = schema.field_indices.find(
+            impl::string_trim_after(key, m_settings.attribute_separator[0]));
+
+        if (field_index_it != schema.field_indices.end() &&
+            field_children[field_index_it->second] == npos) {
+            field_children[field_index_it->second] = i;
+        }
+    }
+
+    return field_children;
+}
+
+template <typename Node>
+auto Validator<Node>::type_is_generic(const std::string &type) const -> bool {
+    return type.find(m_settings.generic_brackets[0]) != std::string::npos;
+}
+
+template <typename Node>
+auto Validator<Node>::parse_generic_type(const std::string &type) const -> GenericType {
+    GenericType generic_type{};
+
+    enum {
+        ST_NAME,
+        ST_ARGS,
+        ST_SEP,
+        ST_END,
+    } state = ST_NAME;
+
+    int level = 0;
+    std::string_view arg;
+
+    for (auto it = type.cbegin(); it != type.cend(); ++it) {
+        MIROIR_ASSERT(state != ST_END, "invalid generic parser intermediate state: " << type);
+
+        const unsigned char c = *it;
+
+        if (std::isspace(c)) {
+            continue;
+        }
+
+        if (c == m_settings.generic_brackets[0]) {
+            ++level;
+
+            if (level == 1) {
+                state = ST_ARGS;
+                continue; // skip open bracket
+            }
+        } else if (c == m_settings.generic_brackets[1]) {
+            --level;
+
+            if (level == 0) {
+                state = ST_END;
+            }
+        } else if (level == 1 && c == m_settings.generic_separator[0]) {
+            state = ST_SEP;
+        }
+
+        switch (state) {
+        case ST_NAME:
+            generic_type.name += c;
+            break;
+        case ST_ARGS:
+            arg = std::string_view{!arg.empty() ? arg.cbegin() : &(*it), arg.size() + 1};
+            break;
+        case ST_SEP:
+            state = ST_ARGS;
+            [[fallthrough]];
+        case ST_END:
+            MIROIR_ASSERT(!arg.empty(), "generic arg is empty: " << type);
+            generic_type.args.push_back(std::string{arg});
+            arg = std::string_view{};
+            break;
+        default:
+            MIROIR_ASSERT(false, "invalid generic parser state: " << state);
+        }
+    }
+
+    MIROIR_ASSERT(level == 0, "generic brackets are disbalanced: " << type);
+    MIROIR_ASSERT(state == ST_END, "invalid generic parser end state: " << type);
+    MIROIR_ASSERT(!generic_type.name.empty(), "generic name is empty: " << type);
+    MIROIR_ASSERT(!generic_type.args.empty(), "generic args are empty: " << type);
+
+    return generic_type;
+}
+
+template <typename Node>
+auto Validator<Node>::concrete_type(const std::string &type,
+                                    const std::map<std::string, std::string> &where) const
+    -> std::string {
+
+    const auto it = where.find(type);
+    if (it != where.end()) {
+        return it->second;
+    }
+
+    if (!type_is_generic(type)) {
+        return type;
+    }
+
+    // replace generic args recursively, e.g. "map<K;list<V>>" -> "map<string;list<int>>"
+    const GenericType generic_type = parse_generic_type(type);
+    std::string result = generic_type.name + m_settings.generic_brackets[0];
+
+    for (std::size_t i = 0; i < generic_type.args.size(); ++i) {
+        if (i > 0) {
+            result += m_settings.generic_separator;
+        }
+
+        result += concrete_type(generic_type.args[i], where);
+    }
+
+    return result + m_settings.generic_brackets[1];
+}
+
+template <typename Node>
+auto Validator<Node>::make_generic_args(const GenericType &keys, const GenericType &vals,
+                                        const std::map<std::string, std::string> &where) const
+    -> std::map<std::string, std::string> {
+
+    MIROIR_ASSERT(!keys.args.empty(), "generic args are empty");
+    MIROIR_ASSERT(!vals.args.empty(), "generic args are empty");
+    MIROIR_ASSERT(keys.args.size() == vals.args.size(), "generic args count mismatch");
+
+    std::map<std::string, std::string> generic_args;
+
+    for (std::size_t i = 0; i < keys.args.size(); ++i) {
+        const std::string &key = keys.args[i];
+        const std::string &val = vals.args[i];
+        generic_args[key] = concrete_type(val, where);
+    }
+
+    return generic_args;
+}
+
+/// Stream
+
+template <typename Node>
+Validator<Node>::Stream::Stream(const Validator &validator, const ValidationOptions &options)
+    : m_validator{validator}, m_options{options},
+      m_state{.options = m_options,
+              .children_buffers = {},
+              .valid_nodes = {},
+              .stats = m_options.stats},
+      m_error_counter{options.max_error_count}, m_frames{}, m_errors{} {
+
+    const SchemaNode &root = m_validator.m_nodes[m_validator.m_root];
+    push_frame(FrameKind::Root, nullptr, Context{root.expected, m_state, m_error_counter},
+               &m_errors);
+}
+
+template <typename Node> auto Validator<Node>::Stream::begin_sequence() -> bool {
+    return begin(true);
+}
+
+template <typename Node> auto Validator<Node>::Stream::begin_map() -> bool {
+    return begin(false);
+}
+
+template <typename Node> void Validator<Node>::Stream::end() {
+    Frame &frame = m_frames.back();
+
+    if (frame.kind == FrameKind::Skip && frame.count > 0) {
+        --frame.count;
+        return;
+    }
+
+    if (frame.kind == FrameKind::Map) {
+        finish_map(frame);
+        // the pending children are released with the frame
+        m_state.valid_nodes.clear();
+    }
+
+    MIROIR_ASSERT(m_frames.size() > 1, "unexpected end of the document node");
+    m_frames.pop_back();
+    take(m_frames.back());
+}
+
+template <typename Node> void Validator<Node>::Stream::node(const Node &node) {
+    Frame &frame = m_frames.back();
+
+    if (frame.kind == FrameKind::Skip) {
+        return;
+    }
+
+    if (frame.kind == FrameKind::Map && !frame.key.has_value()) {
+        add_key(frame, node);
+    } else {
+        if (frame.kind == FrameKind::Map && frame.pending_field != npos) {
+            frame.pending_children.push_back(PendingChild{
+                .position = frame.count,
+                .key = *frame.key,
+                .value = node,
+                .field = frame.pending_field,
+            });
+        } else if (const std::optional<Slot> slot = next_slot(frame); slot.has_value()) {
+            m_validator.validate(node, *slot->schema, slot->ctx, *slot->errors);
+        }
+
+        take(frame);
+    }
+
+    // the node may be released after the call, so its identity can be taken by the next nodes and
+    // the memoized ones must be forgotten
+    m_state.valid_nodes.clear();
+}
+
+template <typename Node> auto Validator<Node>::Stream::finish() -> std::vector<Error> {
+    std::vector<Error> errors = std::move(m_errors);
+
+    m_errors.clear();
+    m_frames.clear();
+    m_state.valid_nodes.clear();
+    m_error_counter.count.store(0, std::memory_order_relaxed);
+
+    const SchemaNode &root = m_validator.m_nodes[m_validator.m_root];
+    push_frame(FrameKind::Root, nullptr, Context{root.expected, m_state, m_error_counter},
+               &m_errors);
+
+    return errors;
+}
+
+template <typename Node> auto Validator<Node>::Stream::begin(bool is_sequence) -> bool {
+    Frame &frame = m_frames.back();
+
+    if (frame.kind == FrameKind::Skip) {
+        ++frame.count;
+        return true;
+    }
+
+    if (frame.kind == FrameKind::Map && (!frame.key.has_value() || frame.pending_field != npos)) {
+        // keys are matched as a whole, values of the pending children are kept until the end
+        return false;
+    }
+
+    const std::optional<Slot> slot = next_slot(frame);
+
+    if (!slot.has_value() || slot->ctx.is_stopped()) {
+        push_frame(FrameKind::Skip, nullptr, frame.ctx, nullptr);
+        return true;
+    }
+
+    // references to the schema types are followed the same way as in validate_type
+    const SchemaNode *schema = slot->schema;
+    Context ctx = slot->ctx;
+
+    std::vector<const std::string *> type_names;
+
+    for (std::size_t i = 0; i < m_validator.m_types.size(); ++i) {
+        if (schema->kind != SchemaNodeKind::Type ||
+            m_validator.m_types[schema->type].validator != nullptr) {
+            break;
+        }
+
+        if (m_state.stats != nullptr) {
+            type_names.push_back(&m_validator.m_types[schema->type].name);
+        }
+
+        ctx = ctx.with_expected(schema->expected);
+        schema = &m_validator.m_nodes[m_validator.m_types[schema->type].node];
+    }
+
+    if (is_sequence && schema->kind == SchemaNodeKind::AnySequence) {
+        push_frame(FrameKind::Skip, nullptr, ctx, nullptr);
+    } else if (is_sequence && schema->kind == SchemaNodeKind::Sequence) {
+        push_frame(FrameKind::Sequence, schema, ctx, slot->errors);
+    } else if (!is_sequence && schema->kind == SchemaNodeKind::AnyMap) {
+        push_frame(FrameKind::Skip, nullptr, ctx, nullptr);
+    } else if (!is_sequence && schema->kind == SchemaNodeKind::Map &&
+               std::none_of(schema->fields.begin(), schema->fields.end(),
+                            [](const MapField &field) -> bool { return field.is_embed; })) {
+        push_frame(FrameKind::Map, schema, ctx, slot->errors);
+    } else {
+        // node is validated as a whole, e.g. it's a type variant or it has an unexpected type
+        return false;
+    }
+
+    // the node is passed as events, so the dispatches are counted without the time
+    if (m_state.stats != nullptr) {
+        ++m_state.stats->node_count;
+
+        for (const std::string *type_name : type_names) {
+            ++m_state.stats->types[*type_name].dispatch_count;
+        }
+    }
+
+    return true;
+}
+
+template <typename Node>
+void Validator<Node>::Stream::push_frame(FrameKind kind, const SchemaNode *schema,
+                                         const Context &ctx, std::vector<Error> *errors) {
+
+    const bool is_map = kind == FrameKind::Map;
+
+    m_frames.push_back(Frame{
+        .kind = kind,
+        .schema = schema,
+        .ctx = ctx,
+        .errors = errors,
+        .count = 0,
+        .key = std::nullopt,
+        .value = std::nullopt,
+        .pending_field = npos,
+        .key_type = npos,
+        .child_errors = {},
+        .field_errors = std::vector<std::vector<Error>>(is_map ? schema->fields.size() : 0),
+        .field_is_found = std::vector<char>(is_map ? schema->fields.size() : 0, false),
+        .key_type_errors =
+            std::vector<std::vector<ChildErrors>>(is_map ? schema->key_types.size() : 0),
+        .key_type_is_found = std::vector<char>(is_map ? schema->key_types.size() : 0, false),
+        .undefined_errors = {},
+        .pending_children = {},
+    });
+}
+
+template <typename Node> void Validator<Node>::Stream::take(Frame &frame) {
+    ++frame.count;
+
+    if (frame.kind == FrameKind::Map) {
+        add_child_errors(frame, frame.count - 1);
+        frame.key.reset();
+        frame.value.reset();
+        frame.pending_field = npos;
+    }
+}
+
+template <typename Node>
+auto Validator<Node>::Stream::next_slot(Frame &frame) const -> std::optional<Slot> {
+    switch (frame.kind) {
+    case FrameKind::Root:
+        MIROIR_ASSERT(frame.count == 0, "document has more than one root node");
+        return Slot{
+            .schema = &m_validator.m_nodes[m_validator.m_root],
+            .ctx = frame.ctx,
+            .errors = frame.errors,
+        };
+    case FrameKind::Sequence:
+        return Slot{
+            .schema = &m_validator.m_nodes[frame.schema->children[0]],
+            .ctx = frame.ctx.appending_index(frame.count),
+            .errors = frame.errors,
+        };
+    case FrameKind::Map:
+        return frame.value;
+    case FrameKind::Skip:
+        return std::nullopt;
+    }
+
+    MIROIR_ASSERT(false, "invalid frame kind: " << static_cast<int>(frame.kind));
+    return std::nullopt;
+}
+
+template <typename Node> void Validator<Node>::Stream::add_key(Frame &frame, const Node &key) {
+    const SchemaNode &schema = *frame.schema;
+    const Node &frame_key = frame.key.emplace(key);
+
+    // fields are matched the same way as in find_fields
+    if (NodeAccessor::is_scalar(frame_key)) {
+        std::string buffer;
+        const std::string_view key_str = impl::scalar_view(frame_key, buffer);
+        const auto field_index_it = schema.field_indices.find(key_str);
+
+        if (field_index_it != schema.field_indices.end() &&
+            !frame.field_is_found[field_index_it->second]) {
+            const std::size_t field_index = field_index_it->second;
+            const MapField &field = schema.fields[field_index];
+
+            frame.field_is_found[field_index] = true;
+            frame.value = Slot{
+                .schema = &m_validator.m_nodes[field.node],
+                .ctx = frame.ctx.appending_path(field.key),
+                .errors = &frame.field_errors[field_index],
+            };
+
+            return;
+        }
+
+        if (m_validator.m_settings.ignore_attributes) {
+            const auto attr_field_index_it = schema.field_indices.find(impl::string_trim_after(
+                key_str, m_validator.m_settings.attribute_separator[0]));
+
+            if (attr_field_index_it != schema.field_indices.end() &&
+                !frame.field_is_found[attr_field_index_it->second]) {
+                frame.pending_field = attr_field_index_it->second;
+                return;
+            }
+        }
+    }
+
+    frame.value = match_key_types(frame, frame_key, frame.count);
+}
+
+template <typename Node>
+auto Validator<Node>::Stream::match_key_types(Frame &frame, const Node &key, std::size_t position)
+    -> std::optional<Slot> {
+
+    const SchemaNode &schema = *frame.schema;
+
+    for (std::size_t i = 0; i < schema.key_types.size(); ++i) {
+        const MapKeyType &key_type = schema.key_types[i];
+
+        if (m_state.stats != nullptr) {
+            ++m_state.stats->key_probe_count;
+        }
+
+        if (m_validator.validate_type(key, key_type.type, frame.ctx)) {
+            frame.key_type_is_found[i] = true;
+            frame.key_type = i;
+
+            return Slot{
+                .schema = &m_validator.m_nodes[key_type.node],
+                .ctx = frame.ctx.appending_key(key),
+                .errors = &frame.child_errors,
+            };
+        }
+    }
+
+    // node not defined in the schema
+    std::vector<Error> errors;
+    m_validator.add_error(ErrorType::UndefinedNode, frame.ctx.appending_key(key), errors);
+
+    if (!errors.empty()) {
+        frame.undefined_errors.push_back(
+            ChildErrors{.position = position, .errors = std::move(errors)});
+    }
+
+    return std::nullopt;
+}
+
+template <typename Node>
+void Validator<Node>::Stream::add_child_errors(Frame &frame, std::size_t position) {
+    if (frame.key_type != npos && !frame.child_errors.empty()) {
+        frame.key_type_errors[frame.key_type].push_back(
+            ChildErrors{.position = position, .errors = std::move(frame.child_errors)});
+    }
+
+    frame.key_type = npos;
+    frame.child_errors.clear();
+}
+
+template <typename Node> void Validator<Node>::Stream::finish_map(Frame &frame) {
+    const SchemaNode &schema = *frame.schema;
+
+    for (const PendingChild &child : frame.pending_children) {
+        std::optional<Slot> slot;
+
+        if (!frame.field_is_found[child.field]) {
+            const MapField &field = schema.fields[child.field];
+
+            frame.field_is_found[child.field] = true;
+            slot = Slot{
+                .schema = &m_validator.m_nodes[field.node],
+                .ctx = frame.ctx.appending_path(field.key),
+                .errors = &frame.field_errors[child.field],
+            };
+        } else {
+            slot = match_key_types(frame, child.key, child.position);
+        }
+
+        if (slot.has_value()) {
+            m_validator.validate(child.value, *slot->schema, slot->ctx, *slot->errors);
+        }
+
+        add_child_errors(frame, child.position);
+    }
+
+    const auto by_position = [](const auto &lhs, const auto &rhs) -> bool {
+        return lhs.position < rhs.position;
+    };
+
+    std::vector<Error> &errors = *frame.errors;
+
+    for (std::size_t i = 0; i < schema.fields.size(); ++i) {
+        const MapField &field = schema.fields[i];
+        std::move(frame.field_errors[i].begin(), frame.field_errors[i].end(),
+                  std::back_inserter(errors));
+
+        if (!frame.field_is_found[i] && field.is_required) {
+            // required node not found
+            m_validator.add_error(ErrorType::NodeNotFound, frame.ctx.appending_path(field.key),
+                                  errors);
+        }
+    }
+
+    for (std::size_t i = 0; i < schema.key_types.size(); ++i) {
+        const MapKeyType &key_type = schema.key_types[i];
+        std::sort(frame.key_type_errors[i].begin(), frame.key_type_errors[i].end(), by_position);
+
+        for (ChildErrors &child_errors : frame.key_type_errors[i]) {
+            std::move(child_errors.errors.begin(), child_errors.errors.end(),
+                      std::back_inserter(errors));
+        }
+
+        if (key_type.is_required && !frame.key_type_is_found[i]) {
+            // didn't find a key with required type
+            m_validator.add_error(ErrorType::MissingKeyWithType,
+                                  frame.ctx.with_expected(key_type.name), errors);
+        }
+    }
+
+    std::sort(frame.undefined_errors.begin(), frame.undefined_errors.end(), by_position);
+
+    for (ChildErrors &child_errors : frame.undefined_errors) {
+        std::move(child_errors.errors.begin(), child_errors.errors.end(),
+                  std::back_inserter(errors));
+    }
+}
+
+/// StaticValidator
+
+template <typename Node, typename Schema>
+auto StaticValidator<Node, Schema>::validate(const Node &doc, std::size_t max_error_count) const
+    -> std::vector<Error> {
+
+    const ValidationOptions options{.max_error_count = max_error_count};
+    State state{.options = options, .children_buffers = {}, .valid_nodes = {}, .stats = nullptr};
+    ErrorCounter error_counter{max_error_count};
+    const Context ctx{expected<Schema>(), state, error_counter};
+    std::vector<Error> errors;
+    validate<Schema>(doc, ctx, errors);
+    return errors;
+}
+
+template <typename Node, typename Schema>
+auto StaticValidator<Node, Schema>::is_valid(const Node &doc) const -> bool {
+    const ValidationOptions options{};
+    State state{.options = options, .children_buffers = {}, .valid_nodes = {}, .stats = nullptr};
+    ErrorCounter error_counter{1};
+    const Context ctx = Context{expected<Schema>(), state, error_counter}.with_check_only();
+    std::vector<Error> errors; // stays empty, errors are only counted
+    validate<Schema>(doc, ctx, errors);
+    return !error_counter.has_errors();
+}
+
+template <typename Node, typename Schema>
+template <typename T>
+auto StaticValidator<Node, Schema>::render() -> std::string {
+    // joins the rendered items with a comma
+    const auto join = [](std::initializer_list<std::string> items) -> std::string {
+        std::string str;
+
+        for (const std::string &item : items) {
+            str += str.empty() ? item : ", " + item;
+        }
+
+        return str;
+    };
+
+    if constexpr (impl::is_static_named<T>) {
+        return std::string{T::name};
+    } else if constexpr (impl::is_static_seq<T>) {
+        return "[" + render<typename T::item>() + "]";
+    } else if constexpr (impl::is_static_one_of<T>) {
+        return [&]<typename... Ts>(const schema::OneOf<Ts...> * /*type*/) -> std::string {
+            return "[" + join({render<Ts>()...}) + "]";
+        }(static_cast<const T *>(nullptr));
+    } else if constexpr (impl::is_static_values<T>) {
+        return [&]<schema::Name... Vs>(const schema::Values<Vs...> * /*type*/) -> std::string {
+            return "!<!variant> [" + join({std::string{Vs.view()}...}) + "]";
+        }(static_cast<const T *>(nullptr));
+    } else {
+        return [&]<typename... Members>(const schema::Struct<Members...> * /*type*/) {
+            // renders the member as the key-value pair of the map
+            const auto render_member = []<typename Member>(const Member * /*member*/) {
+                if constexpr (impl::is_embed_member<Member>) {
+                    return "_: !<!embed> " + render<typename Member::embedded>();
+                } else {
+                    std::string key;
+
+                    if constexpr (impl::is_field_member<Member>) {
+                        key = Member::key;
+                    } else {
+                        key = "$" + std::string{Member::key_type::name};
+                    }
+
+                    const std::string tag = Member::is_required ? "" : "!<!optional> ";
+                    return key + ": " + tag + render<typename Member::value>();
+                }
+            };
+
+            return "{" + join({render_member(static_cast<const Members *>(nullptr))...}) + "}";
+        }(static_cast<const T *>(nullptr));
+    }
+}
+
+template <typename Node, typename Schema>
+template <typename T>
+auto StaticValidator<Node, Schema>::expected() -> const Expected & {
+    // variants are listed the same way as by dump_expected
+    static const Expected expected = []() -> std::string {
+        if constexpr (impl::is_static_one_of<T>) {
+            return [&]<typename... Ts>(const schema::OneOf<Ts...> * /*type*/) {
+                return "one of" + (("\n\t- " + render<Ts>()) + ...);
+            }(static_cast<const T *>(nullptr));
+        } else if constexpr (impl::is_static_values<T>) {
+            return [&]<schema::Name... Vs>(const schema::Values<Vs...> * /*type*/) {
+                if constexpr (sizeof...(Vs) == 1) {
+                    return render<T>();
+                } else {
+                    return "one of" + (("\n\t- " + std::string{Vs.view()}) + ...);
+                }
+            }(static_cast<const T *>(nullptr));
+        } else {
+            return render<T>();
+        }
+    }();
+
+    return expected;
+}
+
+template <typename Node, typename Schema>
+template <typename T>
+void StaticValidator<Node, Schema>::validate(const Node &doc, const Context &ctx,
+                                             std::vector<Error> &errors) {
+
+    static_assert(impl::is_static_schema<T>, "not a schema type, see miroir::schema");
+
+    if (ctx.is_stopped()) {
+        return;
+    }
+
+    validate_node(doc, static_cast<const T *>(nullptr), ctx, errors);
+}
+
+template <typename Node, typename Schema>
+template <typename K>
+auto StaticValidator<Node, Schema>::validate_key(const Node &key, const Context &ctx) -> bool {
+    static_assert(impl::is_static_named<K>, "key type must be a built-in, custom or named type");
+
+    // the first error is enough to reject the key
+    ErrorCounter error_counter{1};
+    Context key_ctx = ctx.with_error_counter(error_counter).with_check_only();
+    key_ctx.embed_claims = nullptr; // node is a key, not a part of the embedded map
+
+    std::vector<Error> errors;
+    validate<K>(key, key_ctx, errors);
+    return !error_counter.has_errors();
+}
+
+template <typename Node, typename Schema>
+template <schema::BuiltinKind Kind>
+void StaticValidator<Node, Schema>::validate_node(const Node &doc,
+                                                  const schema::Builtin<Kind> * /*type*/,
+                                                  const Context &ctx, std::vector<Error> &errors) {
+
+    static const Expected expected{std::string{schema::builtin_name(Kind)}};
+
+    if (ctx.embed_claims != nullptr) {
+        // embedded node is not a map
+        ctx.embed_claims->is_all = true;
+    }
+
+    if (!impl::node_is_builtin<Kind>(doc)) {
+        // node has invalid type
+        Base::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+    }
+}
+
+template <typename Node, typename Schema>
+template <schema::Name TypeName, auto Function>
+void StaticValidator<Node, Schema>::validate_node(const Node &doc,
+                                                  const schema::Custom<TypeName, Function> *
+                                                  /*type*/,
+                                                  const Context &ctx, std::vector<Error> &errors) {
+
+    static_assert(std::is_invocable_r_v<bool, decltype(Function), const Node &>,
+                  "custom type must be called as bool(const Node &)");
+
+    static const Expected expected{std::string{TypeName.view()}};
+
+    if (ctx.embed_claims != nullptr) {
+        // embedded node is not a map
+        ctx.embed_claims->is_all = true;
+    }
+
+    if (!Function(doc)) {
+        // node has invalid type
+        Base::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+    }
+}
+
+template <typename Node, typename Schema>
+template <schema::Name TypeName, typename Definition>
+void StaticValidator<Node, Schema>::validate_node(const Node &doc,
+                                                  const schema::Type<TypeName, Definition> *
+                                                  /*type*/,
+                                                  const Context &ctx, std::vector<Error> &errors) {
+
+    static const Expected expected{std::string{TypeName.view()}};
+    validate<Definition>(doc, ctx.with_expected(expected), errors);
+}
+
+template <typename Node, typename Schema>
+template <typename T>
+void StaticValidator<Node, Schema>::validate_node(const Node &doc, const schema::Seq<T> * /*type*/,
+                                                  const Context &ctx, std::vector<Error> &errors) {
+
+    if (ctx.embed_claims != nullptr) {
+        // embedded node is not a map
+        ctx.embed_claims->is_all = true;
+    }
+
+    if (!NodeAccessor::is_sequence(doc)) {
+        // schema node is a sequence but document node is not a sequence
+        Base::add_error(ErrorType::InvalidValueType, ctx, errors);
+        return;
+    }
+
+    const std::size_t size = NodeAccessor::size(doc);
+
+    for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {
+        validate<T>(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);
+    }
+}
+
+template <typename Node, typename Schema>
+template <typename... Ts>
+void StaticValidator<Node, Schema>::validate_node(const Node &doc,
+                                                  const schema::OneOf<Ts...> * /*type*/,
+                                                  const Context &ctx, std::vector<Error> &errors) {
+
+    std::vector<std::vector<Error>> grouped_errors(sizeof...(Ts));
+    bool has_skipped_variants = false;
+
+    // variants are tried in order until the first valid one
+    const bool is_valid = [&]<std::size_t... I>(std::index_sequence<I...>) -> bool {
+        return ((matches_shape<Ts>(doc) ? validate_variant<Ts>(doc, ctx, grouped_errors[I])
+                                        : (has_skipped_variants = true, false)) ||
+                ...);
+    }(std::index_sequence_for<Ts...>{});
+
+    if (is_valid) {
+        // found correct node type
+        return;
+    }
+
+    if (has_skipped_variants && !ctx.is_check_only) {
+        // skipped variants are validated only to report their errors
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((matches_shape<Ts>(doc) || validate_variant<Ts>(doc, ctx, grouped_errors[I])), ...);
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    if (ctx.embed_claims != nullptr) {
+        // don't report nodes of the invalid embedded node as undefined
+        ctx.embed_claims->is_all = true;
+    }
+
+    // document node has invalid type
+    Base::add_error(ErrorType::InvalidValueType, ctx, errors, std::move(grouped_errors));
+}
+
+template <typename Node, typename Schema>
+template <schema::Name... Vs>
+void StaticValidator<Node, Schema>::validate_node(const Node &doc,
+                                                  const schema::Values<Vs...> * /*type*/,
+                                                  const Context &ctx, std::vector<Error> &errors) {
+
+    if (ctx.embed_claims != nullptr) {
+        // embedded node is not a map
+        ctx.embed_claims->is_all = true;
+    }
+
+    if (!impl::StaticValues<schema::Values<Vs...>>::contains(doc)) {
+        // document node has invalid value
+        Base::add_error(ErrorType::InvalidValue, ctx, errors);
+    }
+}
+
+template <typename Node, typename Schema>
+template <typename... Members>
+void StaticValidator<Node, Schema>::validate_node(const Node &doc,
+                                                  const schema::Struct<Members...> * /*type*/,
+                                                  const Context &ctx, std::vector<Error> &errors) {
+
+    using Struct = impl::StaticStruct<schema::Struct<Members...>>;
+    const bool doc_is_map = NodeAccessor::is_map(doc);
+
+    if constexpr (sizeof...(Members) == 0) {
+        if (ctx.embed_claims != nullptr) {
+            // embedded any map claims all nodes
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!doc_is_map) {
+            // document node must be a map
+            Base::add_error(ErrorType::InvalidValueType, ctx, errors);
+        }
+
+        // allow any map on empty struct
+        return;
+    }
+
+    if (!doc_is_map) {
+        (
+            [&] {
+                if constexpr (impl::is_field_member<Members>) {
+                    if (Members::is_required) {
+                        // required node not found
+                        Base::add_error(ErrorType::NodeNotFound,
+                                        ctx.appending_path(impl::static_field_key<Members>()),
+                                        errors);
+                    }
+                }
+            }(),
+            ...);
+
+        if (!Struct::has_required_fields || Struct::has_key_types) {
+            // document node must be a map
+            Base::add_error(ErrorType::InvalidValueType, ctx, errors);
+        }
+
+        return;
+    }
+
+    // children of the document node
+    std::vector<MapChild> children = ctx.state->acquire_children();
+    children.reserve(NodeAccessor::size(doc));
+
+    for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
+        children.push_back(MapChild{
+            .key = it->first,
+            .value = it->second,
+            .key_type = npos,
+            .is_validated = false,
+        });
+    }
+
+    // positions of the children for the fields by the member index, the first child is used if
+    // the keys are duplicated
+    std::array<std::size_t, sizeof...(Members)> field_children;
+    field_children.fill(npos);
+    std::string buffer;
+
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        if (!NodeAccessor::is_scalar(children[i].key)) {
+            continue;
+        }
+
+        const std::size_t member_index = Struct::find(impl::scalar_view(children[i].key, buffer));
+
+        if (member_index != npos && field_children[member_index] == npos) {
+            field_children[member_index] = i;
+        }
+    }
+
+    // children claimed by the embedded schema nodes, nested embeds claim children for the outer map
+    EmbedClaims claims{.children = {}, .is_all = false};
+    EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+
+    // validate document structure
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((!ctx.is_stopped() && (validate_member<Members>(doc, children, field_children[I], ctx,
+                                                          embed_claims, errors),
+                                true)) &&
+         ...);
+    }(std::index_sequence_for<Members...>{});
+
+    if constexpr (Struct::has_key_types) {
+        // match keys of the children with key types, each key is matched once in the schema order
+        for (std::size_t i = 0; i < children.size() && !ctx.is_stopped(); ++i) {
+            MapChild &child = children[i];
+
+            if (!child.is_validated) {
+                [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    (match_key_type<Members>(child, I, ctx) || ...);
+                }(std::index_sequence_for<Members...>{});
+            }
+        }
+
+        // validate key types
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((!ctx.is_stopped() && (validate_key_type<Members>(children, I, ctx, errors), true)) &&
+             ...);
+        }(std::index_sequence_for<Members...>{});
+    }
+
+    if (ctx.embed_claims != nullptr) {
+        // undefined nodes are found by the outer map
+        for (std::size_t i = 0; i < children.size(); ++i) {
+            if (children[i].is_validated) {
+                ctx.embed_claims->claim(i);
+            }
+        }
+    } else {
+        // find undefined nodes
+        for (std::size_t i = 0; i < children.size() && !ctx.is_stopped(); ++i) {
+            if (children[i].is_validated || claims.is_claimed(i)) {
+                continue;
+            }
+
+            // node not defined in the schema
+            Base::add_error(ErrorType::UndefinedNode, ctx.appending_key(children[i].key), errors);
+        }
+    }
+
+    ctx.state->release_children(std::move(children));
+}
+
+template <typename Node, typename Schema>
+template <typename T>
+auto StaticValidator<Node, Schema>::validate_variant(const Node &doc, const Context &ctx,
+                                                     std::vector<Error> &variant_errors) -> bool {
+
+    // errors of the variant are limited separately, they aren't the resulting errors
+    const std::size_t variant_max_error_count =
+        ctx.is_check_only ? 1 : ctx.state->options.max_error_count;
+    ErrorCounter variant_error_counter{variant_max_error_count};
+    EmbedClaims variant_claims{.children = {}, .is_all = false};
+
+    Context variant_ctx =
+        ctx.with_expected(expected<T>()).with_error_counter(variant_error_counter);
+
+    if (ctx.embed_claims != nullptr) {
+        variant_ctx = variant_ctx.with_embed(variant_claims);
+    }
+
+    validate<T>(doc, variant_ctx, variant_errors);
+
+    if (variant_error_counter.has_errors()) {
+        return false;
+    }
+
+    if (ctx.embed_claims != nullptr) {
+        ctx.embed_claims->claim(variant_claims);
+    }
+
+    return true;
+}
+
+template <typename Node, typename Schema>
+template <typename Member>
+void StaticValidator<Node, Schema>::validate_member(const Node &doc,
+                                                    std::vector<MapChild> &children,
+                                                    std::size_t child_index, const Context &ctx,
+                                                    EmbedClaims &embed_claims,
+                                                    std::vector<Error> &errors) {
+
+    if constexpr (impl::is_embed_member<Member>) {
+        validate<typename Member::embedded>(doc, ctx.with_embed(embed_claims), errors);
+    } else if constexpr (impl::is_field_member<Member>) {
+        const Context child_ctx = ctx.appending_path(impl::static_field_key<Member>());
+
+        if (child_index != npos) {
+            MapChild &child = children[child_index];
+            validate<typename Member::value>(child.value, child_ctx, errors);
+            child.is_validated = true;
+        } else if (Member::is_required) {
+            // required node not found
+            Base::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+        }
+    }
+}
+
+template <typename Node, typename Schema>
+template <typename Member>
+auto StaticValidator<Node, Schema>::match_key_type(MapChild &child, std::size_t member_index,
+                                                   const Context &ctx) -> bool {
+
+    if constexpr (impl::is_key_type_member<Member>) {
+        if (validate_key<typename Member::key_type>(child.key, ctx)) {
+            child.key_type = member_index;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Node, typename Schema>
+template <typename Member>
+void StaticValidator<Node, Schema>::validate_key_type(std::vector<MapChild> &children,
+                                                      std::size_t member_index,
+                                                      const Context &ctx,
+                                                      std::vector<Error> &errors) {
+
+    if constexpr (impl::is_key_type_member<Member>) {
+        static const Expected expected{std::string{Member::key_type::name}};
+        bool key_type_is_found = false;
+
+        for (std::size_t i = 0; i < children.size() && !ctx.is_stopped(); ++i) {
+            MapChild &child = children[i];
+
+            if (child.key_type != member_index) {
+                continue;
+            }
+
+            validate<typename Member::value>(child.value, ctx.appending_key(child.key), errors);
+            child.is_validated = true;
+            key_type_is_found = true;
+        }
+
+        if (Member::is_required && !key_type_is_found) {
+            // didn't find a key with required type
+            Base::add_error(ErrorType::MissingKeyWithType, ctx.with_expected(expected), errors);
+        }
+    }
+}
+
+template <typename Node, typename Schema>
+template <typename T>
+auto StaticValidator<Node, Schema>::matches_shape(const Node &doc) -> bool {
+    using Definition = typename impl::StaticDefinition<T>::type;
+
+    if constexpr (impl::is_static_seq<Definition>) {
+        return NodeAccessor::is_sequence(doc);
+    } else if constexpr (impl::is_static_struct<Definition>) {
+        return [&]<typename... Members>(const schema::Struct<Members...> * /*type*/) -> bool {
+            if (!NodeAccessor::is_map(doc)) {
+                return false;
+            }
+
+            // returns false if the required field isn't found or has invalid value, tag-like
+            // fields (e.g. `kind: Values<"circle">`) discriminate the variants by value
+            const auto matches_field = [&]<typename Member>(const Member * /*member*/) -> bool {
+                if constexpr (impl::is_field_member<Member>) {
+                    if (!Member::is_required) {
+                        return true;
+                    }
+
+                    using Value = typename impl::StaticDefinition<typename Member::value>::type;
+                    std::string buffer;
+
+                    for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
+                        if (NodeAccessor::is_scalar(it->first) &&
+                            impl::scalar_view(it->first, buffer) == Member::key) {
+                            if constexpr (impl::is_static_values<Value>) {
+                                return impl::StaticValues<Value>::contains(it->second);
+                            } else {
+                                return true;
+                            }
+                        }
+                    }
+
+                    return false;
+                } else {
+                    return true;
+                }
+            };
+
+            return (matches_field(static_cast<const Members *>(nullptr)) && ...);
+        }(static_cast<const Definition *>(nullptr));
+    } else {
+        // built-in types and value variants are cheap to validate, nested variants are validated
+        return true;
+    }
+}
+
+/// GeneratedRuntime
+
+template <typename Node>
+auto GeneratedRuntime<Node>::validate(const Node &doc, std::size_t max_error_count,
+                                      const Expected &expected, Function root)
+    -> std::vector<Error> {
+
+    const ValidationOptions options{.max_error_count = max_error_count};
+    typename Base::State state{
+        .options = options, .children_buffers = {}, .valid_nodes = {}, .stats = nullptr};
+    typename Base::ErrorCounter error_counter{max_error_count};
+    const Context ctx{expected, state, error_counter};
+    std::vector<Error> errors;
+    root(doc, ctx, errors);
+    return errors;
+}
+
+template <typename Node>
+auto GeneratedRuntime<Node>::is_valid(const Node &doc, const Expected &expected, Function root)
+    -> bool {
+
+    const ValidationOptions options{};
+    typename Base::State state{
+        .options = options, .children_buffers = {}, .valid_nodes = {}, .stats = nullptr};
+    typename Base::ErrorCounter error_counter{1};
+    const Context ctx = Context{expected, state, error_counter}.with_check_only();
+    std::vector<Error> errors; // stays empty, errors are only counted
+    root(doc, ctx, errors);
+    return !error_counter.has_errors();
+}
+
+template <typename Node>
+void GeneratedRuntime<Node>::add_error(ErrorType type, const Context &ctx,
+                                       std::vector<Error> &errors,
+                                       std::vector<std::vector<Error>> &&variant_errors) {
+
+    Base::add_error(type, ctx, errors, std::move(variant_errors));
+}
+
+template <typename Node>
+auto GeneratedRuntime<Node>::validate_variant(const Node &doc, const Context &ctx,
+                                              const Expected &expected, Function variant,
+                                              std::vector<Error> &variant_errors) -> bool {
+
+    // errors of the variant are limited separately, they aren't the resulting errors
+    const std::size_t variant_max_error_count =
+        ctx.is_check_only ? 1 : ctx.state->options.max_error_count;
+    typename Base::ErrorCounter variant_error_counter{variant_max_error_count};
+    EmbedClaims variant_claims{.children = {}, .is_all = false};
+
+    Context variant_ctx = ctx.with_expected(expected).with_error_counter(variant_error_counter);
+
+    if (ctx.embed_claims != nullptr) {
+        variant_ctx = variant_ctx.with_embed(variant_claims);
+    }
+
+    variant(doc, variant_ctx, variant_errors);
+
+    if (variant_error_counter.has_errors()) {
+        return false;
+    }
+
+    if (ctx.embed_claims != nullptr) {
+        ctx.embed_claims->claim(variant_claims);
+    }
+
+    return true;
+}
+
+template <typename Node>
+auto GeneratedRuntime<Node>::validate_key(const Node &key, const Context &ctx, Function type)
+    -> bool {
+
+    // the first error is enough to reject the key
+    typename Base::ErrorCounter error_counter{1};
+    Context key_ctx = ctx.with_error_counter(error_counter).with_check_only();
+    key_ctx.embed_claims = nullptr; // node is a key, not a part of the embedded map
+
+    std::vector<Error> errors;
+    type(key, key_ctx, errors);
+    return !error_counter.has_errors();
+}
+
+template <typename Node>
+auto GeneratedRuntime<Node>::begin_map(const Node &doc, const Context &ctx)
+    -> std::vector<MapChild> {
+
+    std::vector<MapChild> children = ctx.state->acquire_children();
+    children.reserve(NodeAccessor::size(doc));
+
+    for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
+        children.push_back(MapChild{
+            .key = it->first,
+            .value = it->second,
+            .key_type = npos,
+            .is_validated = false,
+        });
+    }
+
+    return children;
+}
+
+template <typename Node>
+void GeneratedRuntime<Node>::finish_map(std::vector<MapChild> &&children,
+                                        const EmbedClaims &claims, const Context &ctx,
+                                        std::vector<Error> &errors) {
+
+    if (ctx.embed_claims != nullptr) {
+        // undefined nodes are found by the outer map
+        for (std::size_t i = 0; i < children.size(); ++i) {
+            if (children[i].is_validated) {
+                ctx.embed_claims->claim(i);
+            }
+        }
+    } else {
+        // find undefined nodes
+        for (std::size_t i = 0; i < children.size() && !ctx.is_stopped(); ++i) {
+            if (children[i].is_validated || claims.is_claimed(i)) {
+                continue;
+            }
+
+            // node not defined in the schema
+            add_error(ErrorType::UndefinedNode, ctx.appending_key(children[i].key), errors);
+        }
+    }
+
+    ctx.state->release_children(std::move(children));
+}
+
+template <typename Node>
+void GeneratedRuntime<Node>::find_fields(const std::vector<MapChild> &children,
+                                         std::span<const Field> fields, char attribute_separator,
+                                         std::span<std::size_t> field_children) {
+
+    std::fill(field_children.begin(), field_children.end(), npos);
+    std::size_t found_count = 0;
+    std::string buffer;
+
+    // returns the field of the key, nullptr if not found
+    const auto find_field = [&](std::string_view key) -> const Field * {
+        const auto it = std::lower_bound(
+            fields.begin(), fields.end(), key,
+            [](const Field &field, std::string_view key) -> bool { return field.key < key; });
+
+        return it != fields.end() && it->key == key ? &*it : nullptr;
+    };
+
+    // exact keys first, the first child is used if the keys are duplicated
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        if (!NodeAccessor::is_scalar(children[i].key)) {
+            continue;
+        }
+
+        const Field *field = find_field(impl::scalar_view(children[i].key, buffer));
+
+        if (field != nullptr && field_children[field->index] == npos) {
+            field_children[field->index] = i;
+            ++found_count;
+        }
+    }
+
+    if (attribute_separator == '\0' || found_count == fields.size()) {
+        return;
+    }
+
+    // then keys with attributes
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        if (!NodeAccessor::is_scalar(children[i].key)) {
+            continue;
+        }
+
+        const std::string_view key = impl::scalar_view(children[i].key, buffer);
+        const Field *field = find_field(impl::string_trim_after(key, attribute_separator));
+
+        if (field != nullptr && field_children[field->index] == npos) {
+            field_children[field->index] = i;
+        }
+    }
+}
+
+template <typename Node>
+auto GeneratedRuntime<Node>::find_value(const Node &doc, std::string_view key,
+                                        char attribute_separator) -> std::optional<Node> {
+
+    std::string buffer;
+
+    // exact key first, the first child is used if the keys are duplicated
+    for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
+        if (NodeAccessor::is_scalar(it->first) && impl::scalar_view(it->first, buffer) == key) {
+            return it->second;
+        }
+    }
+
+    if (attribute_separator == '\0') {
+        return std::nullopt;
+    }
+
+    // then key with attributes
+    for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
+        if (NodeAccessor::is_scalar(it->first) &&
+            impl::string_trim_after(impl::scalar_view(it->first, buffer), attribute_separator) ==
+                key) {
+            return it->second;
+        }
+    }
+
+    return std::nullopt;
+}
+
+template <typename Node>
+auto GeneratedRuntime<Node>::values_contain(const Node &doc,
+                                            std::span<const std::string_view> scalars,
+                                            std::span<const std::string_view> dumps) -> bool {
+
+    return impl::values_contain(doc, scalars, dumps);
+}
+
+/// CompiledSchema
+
+template <typename Node>
+auto CompiledSchema<Node>::settings(const Base &validator) -> const SchemaSettings & {
+    return validator.m_settings;
+}
+
+template <typename Node>
+auto CompiledSchema<Node>::types(const Base &validator) -> const std::vector<Type> & {
+    return validator.m_types;
+}
+
+template <typename Node>
+auto CompiledSchema<Node>::nodes(const Base &validator) -> const std::vector<SchemaNode> & {
+    return validator.m_nodes;
+}
+
+template <typename Node>
+auto CompiledSchema<Node>::root(const Base &validator) -> SchemaNodeId {
+    return validator.m_root;
+}
+
+} // namespace miroir
+
+#endif // ifdef MIROIR_IMPLEMENTATION
+
+#ifdef MIROIR_YAMLCPP_SPECIALIZATION
+
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+#include <type_traits>
+
+namespace miroir {
+
+template <> struct NodeAccessor<YAML::Node> {
+    using Node = YAML::Node;
+    using Iterator = YAML::const_iterator;
+
+    static auto is_defined(const Node &node) -> bool { return node.IsDefined(); }
+
+    static auto is_explicit(const Node &node) -> bool {
+        // see: https://yaml.org/spec/1.2.2/#24-tags
+        // Explicit typing is denoted with a tag using the exclamation point (“!”) symbol.
+        return node.Tag() == "!";
+    }
+
+    static auto is_scalar(const Node &node) -> bool { return node.IsScalar(); }
+    static auto is_sequence(const Node &node) -> bool { return node.IsSequence(); }
+    static auto is_map(const Node &node) -> bool { return node.IsMap(); }
+
+    template <typename Key> static auto at(const Node &node, const Key &key) -> Node {
+        MIROIR_ASSERT(node.IsSequence() || node.IsMap(),
+                      "node is not a sequence or a map: " << dump(node));
+        return node[key];
+    }
+
+    template <typename T> static auto as(const Node &node) -> T { return node.as<T>(); }
+
+    template <typename T> static auto as(const Node &node, const T &fallback) -> T {
+        return node.as<T, T>(fallback);
+    }
+
+    static auto scalar_view(const Node &node) -> std::string_view { return node.Scalar(); }
+
+    static auto tag(const Node &node) -> std::string { return node.Tag().substr(1); }
+
+    static auto dump(const Node &node) -> std::string {
+        YAML::Emitter emitter;
+        emitter.SetSeqFormat(YAML::Flow);
+        emitter.SetMapFormat(YAML::Flow);
+        emitter << node;
+        MIROIR_ASSERT(emitter.good(), "invalid node to emit");
+        return emitter.c_str();
+    }
+
+    static auto equals(const Node &lhs, const Node &rhs) -> bool {
+        if (lhs.IsScalar() && rhs.IsScalar()) {
+            // emitter quotes scalars depending on the content only, so the dumps are equal if the
+            // contents and the emitted tags are equal
+            return lhs.Scalar() == rhs.Scalar() && emitted_tag(lhs) == emitted_tag(rhs);
+        }
+
+        return lhs == rhs || dump(lhs) == dump(rhs);
+    }
+
+    static auto is_same(const Node &lhs, const Node &rhs) -> bool { return lhs == rhs; }
+
+    static auto identity(const Node &node) -> const void * {
+        // scalar is stored in the node data shared by all references to the node (e.g. aliases)
+        return node.IsDefined() ? &node.Scalar() : nullptr;
+    }
+
+    static auto hash(const Node &node) -> std::size_t {
+        // combines the same parts of the node the dump is made of, so equal nodes have equal hashes
+        std::size_t seed = std::hash<std::string>{}(emitted_tag(node));
+
+        switch (node.Type()) {
+        case YAML::NodeType::Null:
+            return hash_combine(seed, std::hash<std::string>{}("~"));
+        case YAML::NodeType::Scalar:
+            return hash_combine(seed, std::hash<std::string>{}(node.Scalar()));
+        case YAML::NodeType::Sequence:
+            seed = hash_combine(seed, static_cast<std::size_t>(YAML::NodeType::Sequence));
+
+            for (const Node &child : node) {
+                seed = hash_combine(seed, hash(child));
+            }
+
+            return seed;
+        case YAML::NodeType::Map:
+            seed = hash_combine(seed, static_cast<std::size_t>(YAML::NodeType::Map));
+
+            for (const auto &child : node) {
+                seed = hash_combine(seed, hash(child.first));
+                seed = hash_combine(seed, hash(child.second));
+            }
+
+            return seed;
+        case YAML::NodeType::Undefined:
+            return seed;
+        }
+
+        return seed;
+    }
+
+    static auto size(const Node &node) -> std::size_t {
+        MIROIR_ASSERT(node.IsSequence() || node.IsMap(),
+                      "node is not a sequence or a map: " << dump(node));
+        return node.size();
+    }
+
+    static auto begin(const Node &node) -> Iterator {
+        MIROIR_ASSERT(node.IsSequence() || node.IsMap(),
+                      "node is not a sequence or a map: " << dump(node));
+        return node.begin();
+    }
+
+    static auto end(const Node &node) -> Iterator {
+        MIROIR_ASSERT(node.IsSequence() || node.IsMap(),
+                      "node is not a sequence or a map: " << dump(node));
+        return node.end();
+    }
+
+    // returns tag of the node as it's emitted to the dump, empty if the tag is omitted
+    static auto emitted_tag(const Node &node) -> std::string {
+        const std::string &tag = node.Tag();
+        return tag == "?" || tag == "!" ? std::string{} : tag;
+    }
+
+    static auto hash_combine(std::size_t seed, std::size_t hash) -> std::size_t {
+        return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+};
+
+// passes events of the yaml-cpp parser to the validator stream, builds only the nodes the stream
+// asks for as a whole, and the anchored nodes to resolve the aliases
+class StreamEventHandler final : public YAML::EventHandler {
+  public:
+    explicit StreamEventHandler(Validator<YAML::Node>::Stream &stream) : m_stream{stream} {}
+
+    void OnDocumentStart(const YAML::Mark & /*mark*/) override { m_anchors.clear(); }
+    void OnDocumentEnd() override {}
+
+    void OnNull(const YAML::Mark & /*mark*/, YAML::anchor_t anchor) override {
+        add(YAML::Node{YAML::NodeType::Null}, anchor);
+    }
+
+    void OnAlias(const YAML::Mark & /*mark*/, YAML::anchor_t anchor) override {
+        add(m_anchors.at(anchor), YAML::NullAnchor);
+    }
+
+    void OnScalar(const YAML::Mark & /*mark*/, const std::string &tag, YAML::anchor_t anchor,
+                  const std::string &value) override {
+        YAML::Node node{value};
+        node.SetTag(tag);
+        add(node, anchor);
+    }
+
+    void OnSequenceStart(const YAML::Mark & /*mark*/, const std::string &tag,
+                         YAML::anchor_t anchor, YAML::EmitterStyle::value style) override {
+        start(YAML::NodeType::Sequence, tag, anchor, style);
+    }
+
+    void OnSequenceEnd() override { finish(); }
+
+    void OnMapStart(const YAML::Mark & /*mark*/, const std::string &tag, YAML::anchor_t anchor,
+                    YAML::EmitterStyle::value style) override {
+        start(YAML::NodeType::Map, tag, anchor, style);
+    }
+
+    void OnMapEnd() override { finish(); }
+
+  private:
+    // sequence/map being built with the key of the next map value
+    struct BuiltNode {
+        YAML::Node node;
+        YAML::anchor_t anchor;
+        std::optional<YAML::Node> key;
+    };
+
+    void start(YAML::NodeType::value type, const std::string &tag, YAML::anchor_t anchor,
+               YAML::EmitterStyle::value style) {
+
+        // anchored nodes are built to be reused by the aliases
+        if (m_built_nodes.empty() && anchor == YAML::NullAnchor &&
+            (type == YAML::NodeType::Sequence ? m_stream.begin_sequence()
+                                              : m_stream.begin_map())) {
+            return;
+        }
+
+        YAML::Node node{type};
+        node.SetTag(tag);
+        node.SetStyle(style);
+        m_built_nodes.push_back(BuiltNode{.node = node, .anchor = anchor, .key = std::nullopt});
+    }
+
+    void finish() {
+        if (m_built_nodes.empty()) {
+            m_stream.end();
+            return;
+        }
+
+        const BuiltNode built_node = m_built_nodes.back();
+        m_built_nodes.pop_back();
+        add(built_node.node, built_node.anchor);
+    }
+
+    void add(const YAML::Node &node, YAML::anchor_t anchor) {
+        if (anchor != YAML::NullAnchor) {
+            m_anchors[anchor] = node;
+        }
+
+        if (m_built_nodes.empty()) {
+            m_stream.node(node);
+            return;
+        }
+
+        BuiltNode &parent = m_built_nodes.back();
+
+        if (parent.node.IsSequence()) {
+            parent.node.push_back(node);
+        } else if (!parent.key.has_value()) {
+            parent.key = node;
+        } else {
+            // duplicated keys are kept the same way as by YAML::Load
+            parent.node.force_insert(*parent.key, node);
+            parent.key.reset();
+        }
+    }
+
+  private:
+    Validator<YAML::Node>::Stream &m_stream;
+    std::vector<BuiltNode> m_built_nodes;
+    std::map<YAML::anchor_t, YAML::Node> m_anchors;
+};
+
+// validates each document of the YAML input without building it in memory as a whole, returns
+// errors of each document, see Validator::Stream
+inline auto validate_stream(const Validator<YAML::Node> &validator, std::istream &input,
+                            const ValidationOptions &options = {})
+    -> std::vector<std::vector<Error<YAML::Node>>> {
+
+    Validator<YAML::Node>::Stream stream{validator, options};
+    StreamEventHandler handler{stream};
+    YAML::Parser parser{input};
+    std::vector<std::vector<Error<YAML::Node>>> errors;
+
+    while (parser.HandleNextDocument(handler)) {
+        errors.push_back(stream.finish());
+    }
+
+    return errors;
+}
+
+/// FlatDocument
+
+class FlatDocument;
+
+// handle of the FlatDocument node, cheap to copy, undefined if the node doesn't exist
+struct FlatNode {
+    const FlatDocument *document = nullptr;
+    std::uint32_t index = UINT32_MAX;
+};
+
+// compact read-only YAML document: nodes are stored in a contiguous array, children of each
+// sequence/map are a contiguous range of node indices, scalars are stored in a single string pool
+// note: nodes reference the document, so it must outlive the nodes, the validator and the errors
+class FlatDocument {
+  public:
+    // parses the first document of the YAML input, like YAML::Load
+    // note: throws YAML::Exception if the input is invalid or the document has more than 4G nodes
+    // or bytes of the scalars
+    explicit FlatDocument(std::istream &input) { load(input); }
+
+    explicit FlatDocument(const std::string &input) {
+        std::istringstream stream{input};
+        load(stream);
+    }
+
+    FlatDocument(const FlatDocument &) = delete;
+    auto operator=(const FlatDocument &) -> FlatDocument & = delete;
+
+    auto root() const -> FlatNode { return FlatNode{.document = this, .index = m_root}; }
 
-        // document node has invalid type
-        const Error err = make_error(ErrorType::InvalidValueType, ctx, grouped_errors);
-        errors.push_back(err);
-    }
-}
+  private:
+    friend struct NodeAccessor<FlatNode>;
+    friend class FlatIterator;
+
+    struct NodeData {
+        std::uint8_t type; // YAML::NodeType::value
+        std::uint32_t tag; // index of the tag
+        // Scalar: range of the string pool, Sequence: range of the children, Map: range of the
+        // children with the keys and the values interleaved
+        std::uint32_t begin;
+        std::uint32_t size;
+    };
 
-template <typename Node>
-void Validator<Node>::validate_map(const Node &doc, const Node &schema, const Context &ctx,
-                                   std::vector<Error> &errors) const {
+    // builds the nodes from the parser events
+    class Builder final : public YAML::EventHandler {
+      public:
+        explicit Builder(FlatDocument &document) : m_document{document} {}
 
-    const bool doc_is_map = NodeAccessor::is_map(doc);
+        void OnDocumentStart(const YAML::Mark & /*mark*/) override {}
+        void OnDocumentEnd() override {}
 
-    if (NodeAccessor::size(schema) == 0) {
-        if (!doc_is_map) {
-            // document node must be a map
-            const Error err = make_error(ErrorType::InvalidValueType, ctx);
-            errors.push_back(err);
+        void OnNull(const YAML::Mark & /*mark*/, YAML::anchor_t anchor) override {
+            add(m_document.make_node(YAML::NodeType::Null, "", 0, 0), anchor);
         }
 
-        // allow any map on empty map in the schema
-        return;
-    }
+        void OnAlias(const YAML::Mark & /*mark*/, YAML::anchor_t anchor) override {
+            add(m_anchors.at(anchor), YAML::NullAnchor);
+        }
 
-    std::vector<Node> validated_nodes;
-    std::vector<std::pair<std::string, Node>> key_types; // key type, schema val node
+        void OnScalar(const YAML::Mark & /*mark*/, const std::string &tag, YAML::anchor_t anchor,
+                      const std::string &value) override {
+            const std::size_t begin = m_document.m_strings.size();
+            m_document.m_strings += value;
+            add(m_document.make_node(YAML::NodeType::Scalar, tag, begin, value.size()), anchor);
+        }
 
-    std::size_t embed_count = 0;
-    bool has_required_nodes = false;
+        void OnSequenceStart(const YAML::Mark & /*mark*/, const std::string &tag,
+                             YAML::anchor_t anchor, YAML::EmitterStyle::value /*style*/) override {
+            start(YAML::NodeType::Sequence, tag, anchor);
+        }
 
-    // validate document structure
-    for (auto it = NodeAccessor::begin(schema); it != NodeAccessor::end(schema); ++it) {
-        const Node schema_val_node = it->second;
-        const std::string schema_val_tag = NodeAccessor::tag(schema_val_node);
+        void OnSequenceEnd() override { finish(); }
 
-        if (tag_is_embed(schema_val_tag)) {
-            if (doc_is_map) {
-                validate(doc, schema_val_node, ctx.with_embed(), errors);
-                ++embed_count;
-            }
-        } else {
-            const Node schema_key_node = it->first;
-            const std::string key = NodeAccessor::template as<std::string>(schema_key_node);
+        void OnMapStart(const YAML::Mark & /*mark*/, const std::string &tag, YAML::anchor_t anchor,
+                        YAML::EmitterStyle::value /*style*/) override {
+            start(YAML::NodeType::Map, tag, anchor);
+        }
 
-            if (!impl::string_is_prefixed(key, m_settings.key_type_prefix)) {
-                const bool node_is_required = tag_is_required(schema_val_tag);
-                const std::optional<Node> child_doc_node = find_node(doc, key);
-                const Context child_ctx = ctx.appending_path(key);
-
-                has_required_nodes = has_required_nodes || node_is_required;
-
-                if (child_doc_node.has_value()) {
-                    validate(child_doc_node.value(), schema_val_node, child_ctx, errors);
-                    validated_nodes.push_back(child_doc_node.value());
-                } else if (node_is_required) {
-                    // required node not found
-                    const Error err = make_error(ErrorType::NodeNotFound, child_ctx);
-                    errors.push_back(err);
-                }
-            } else {
-                const std::string key_type = key.substr(m_settings.key_type_prefix.size());
-                key_types.emplace_back(key_type, schema_val_node);
+        void OnMapEnd() override { finish(); }
+
+      private:
+        // sequence/map being built, its children are added when it ends to keep them contiguous
+        struct BuiltNode {
+            YAML::NodeType::value type;
+            std::string tag;
+            YAML::anchor_t anchor;
+            std::vector<std::uint32_t> children;
+        };
+
+        void start(YAML::NodeType::value type, const std::string &tag, YAML::anchor_t anchor) {
+            // children buffers are reused by the nodes of the same depth
+            if (m_depth == m_built_nodes.size()) {
+                m_built_nodes.emplace_back();
             }
-        }
-    }
 
-    if (!doc_is_map) {
-        if (!has_required_nodes || !key_types.empty()) {
-            // document node must be a map
-            const Error err = make_error(ErrorType::InvalidValueType, ctx);
-            errors.push_back(err);
+            BuiltNode &built_node = m_built_nodes[m_depth++];
+            built_node.type = type;
+            built_node.tag = tag;
+            built_node.anchor = anchor;
+            built_node.children.clear();
         }
 
-        return;
-    }
+        void finish() {
+            const BuiltNode &built_node = m_built_nodes[--m_depth];
+            std::vector<std::uint32_t> &children = m_document.m_children;
+            const std::size_t begin = children.size();
 
-    // validate key types
-    for (const auto &[key_type, schema_val_node] : key_types) {
-        const std::string schema_val_tag = NodeAccessor::tag(schema_val_node);
-        bool key_type_is_valid = !tag_is_required(schema_val_tag);
+            children.insert(children.end(), built_node.children.begin(),
+                            built_node.children.end());
+            add(m_document.make_node(built_node.type, built_node.tag, begin,
+                                     built_node.children.size()),
+                built_node.anchor);
+        }
 
-        for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
-            const Node child_doc_val_node = it->second;
-            if (impl::nodes_contains_node(validated_nodes, child_doc_val_node)) {
-                continue;
+        void add(std::uint32_t index, YAML::anchor_t anchor) {
+            if (anchor != YAML::NullAnchor) {
+                m_anchors[anchor] = index;
             }
 
-            const Node child_doc_key_node = it->first;
-            if (!validate_type(child_doc_key_node, key_type, ctx)) {
-                continue;
+            if (m_depth == 0) {
+                m_document.m_root = index;
+            } else {
+                m_built_nodes[m_depth - 1].children.push_back(index);
             }
+        }
 
-            key_type_is_valid = true;
+      private:
+        FlatDocument &m_document;
+        std::vector<BuiltNode> m_built_nodes;
+        std::size_t m_depth = 0;
+        std::map<YAML::anchor_t, std::uint32_t> m_anchors;
+    };
 
-            const std::string child_key =
-                NodeAccessor::template as<std::string>(child_doc_key_node);
-            validate(child_doc_val_node, schema_val_node, ctx.appending_path(child_key), errors);
-            validated_nodes.push_back(child_doc_val_node);
-        }
+    void load(std::istream &input) {
+        YAML::Parser parser{input};
+        Builder builder{*this};
 
-        if (!key_type_is_valid) {
-            // didn't find a key with required type
-            const Error err =
-                make_error(ErrorType::MissingKeyWithType, ctx.with_expected(key_type));
-            errors.push_back(err);
+        if (!parser.HandleNextDocument(builder)) {
+            // empty input is a null node, like in YAML::Load
+            m_root = make_node(YAML::NodeType::Null, "", 0, 0);
         }
     }
 
-    // find undefined nodes
-    for (auto it = NodeAccessor::begin(doc); it != NodeAccessor::end(doc); ++it) {
-        const Node child_doc_val_node = it->second;
-        if (impl::nodes_contains_node(validated_nodes, child_doc_val_node)) {
-            continue;
+    auto make_node(YAML::NodeType::value type, const std::string &tag, std::size_t begin,
+                   std::size_t size) -> std::uint32_t {
+
+        // tags are interned, most of the nodes have the non-specific ones ("?" or "!")
+        auto tag_it = m_tag_indices.find(tag);
+
+        if (tag_it == m_tag_indices.end()) {
+            tag_it = m_tag_indices.emplace(tag, m_tags.size()).first;
+            m_tags.push_back(tag);
         }
 
-        const Node child_doc_key_node = it->first;
-        const std::string child_key = NodeAccessor::template as<std::string>(child_doc_key_node);
+        // indices and ranges are 32-bit, UINT32_MAX is the index of the undefined node
+        if (m_strings.size() >= UINT32_MAX || m_children.size() >= UINT32_MAX ||
+            m_nodes.size() >= UINT32_MAX) {
+            throw YAML::Exception(YAML::Mark::null_mark(), "document is too large");
+        }
 
-        // node not defined in the schema
-        const Error err = make_error(ErrorType::UndefinedNode, ctx.appending_path(child_key));
-        errors.push_back(err);
-    }
+        m_nodes.push_back(NodeData{
+            .type = static_cast<std::uint8_t>(type),
+            .tag = tag_it->second,
+            .begin = static_cast<std::uint32_t>(begin),
+            .size = static_cast<std::uint32_t>(size),
+        });
 
-    // filter UndefinedNode errors
-    if (!ctx.is_embed) {
-        impl::filter_undefined_node_errors(errors, embed_count);
+        return static_cast<std::uint32_t>(m_nodes.size() - 1);
     }
-}
 
-template <typename Node>
-auto Validator<Node>::tag_is_optional(const std::string &tag) const -> bool {
-    return tag == m_settings.optional_tag;
-}
+  private:
+    std::vector<NodeData> m_nodes;
+    std::vector<std::uint32_t> m_children;
+    std::string m_strings;
+    std::vector<std::string> m_tags;
+    std::map<std::string, std::uint32_t> m_tag_indices;
+    std::uint32_t m_root = UINT32_MAX;
+};
 
-template <typename Node> auto Validator<Node>::tag_is_embed(const std::string &tag) const -> bool {
-    return tag == m_settings.embed_tag;
-}
+// value of the FlatDocument iterator: the child node for sequences, the key and the value for maps
+struct FlatIteratorValue : FlatNode {
+    FlatNode first;
+    FlatNode second;
+};
 
-template <typename Node>
-auto Validator<Node>::tag_is_variant(const std::string &tag) const -> bool {
-    return tag == m_settings.variant_tag;
-}
+class FlatIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlatIteratorValue;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const FlatIteratorValue *;
+    using reference = const FlatIteratorValue &;
 
-template <typename Node>
-auto Validator<Node>::tag_is_required(const std::string &tag) const -> bool {
-    return (m_settings.default_required && !tag_is_optional(tag)) ||
-           (!m_settings.default_required && tag == m_settings.required_tag);
-}
+    FlatIterator() = default;
 
-template <typename Node>
-auto Validator<Node>::find_node(const Node &map, const std::string &key) const
-    -> std::optional<Node> {
+    FlatIterator(const FlatDocument *document, std::size_t position, bool is_map)
+        : m_document{document}, m_position{position}, m_is_map{is_map} {}
 
-    if (!NodeAccessor::is_map(map)) {
-        return std::nullopt;
+    auto operator*() const -> reference {
+        update();
+        return m_value;
     }
 
-    const Node node = NodeAccessor::at(map, key);
+    auto operator->() const -> pointer {
+        update();
+        return &m_value;
+    }
 
-    if (NodeAccessor::is_defined(node)) {
-        return node;
+    auto operator++() -> FlatIterator & {
+        m_position += m_is_map ? 2 : 1;
+        return *this;
     }
 
-    if (m_settings.ignore_attributes) {
-        for (auto it = NodeAccessor::begin(map); it != NodeAccessor::end(map); ++it) {
-            const Node key_node = it->first;
-            const Node val_node = it->second;
-            const std::string node_key = NodeAccessor::template as<std::string>(key_node);
+    auto operator++(int) -> FlatIterator {
+        FlatIterator it = *this;
+        ++*this;
+        return it;
+    }
 
-            if (impl::string_trim_after(node_key, m_settings.attribute_separator[0]) == key) {
-                return std::optional<Node>{val_node};
-            }
-        }
+    auto operator==(const FlatIterator &other) const -> bool {
+        return m_position == other.m_position;
     }
 
-    return std::nullopt;
-}
+  private:
+    void update() const {
+        const std::vector<std::uint32_t> &children = m_document->m_children;
+
+        if (m_is_map) {
+            m_value = FlatIteratorValue{
+                {},
+                FlatNode{.document = m_document, .index = children[m_position]},
+                FlatNode{.document = m_document, .index = children[m_position + 1]},
+            };
+        } else {
+            m_value = FlatIteratorValue{
+                FlatNode{.document = m_document, .index = children[m_position]},
+                {},
+                {},
+            };
+        }
+    }
 
-template <typename Node>
-auto Validator<Node>::type_is_generic(const std::string &type) const -> bool {
-    return m_generic_types_cache.contains(type) ||
-           type.find(m_settings.generic_brackets[0]) != std::string::npos;
-}
+  private:
+    const FlatDocument *m_document = nullptr;
+    std::size_t m_position = 0;
+    bool m_is_map = false;
+    mutable FlatIteratorValue m_value;
+};
 
-template <typename Node>
-auto Validator<Node>::parse_generic_type(const std::string &type) const -> GenericType {
-    const auto cached_generic_type_it = m_generic_types_cache.find(type);
-    if (cached_generic_type_it != m_generic_types_cache.end()) {
-        const GenericType &cached_generic_type = cached_generic_type_it->second;
-        return cached_generic_type;
-    }
+template <> struct NodeAccessor<FlatNode> {
+    using Node = FlatNode;
+    using Iterator = FlatIterator;
 
-    GenericType generic_type{};
+    static auto is_defined(const Node &node) -> bool { return node.index != UINT32_MAX; }
 
-    enum {
-        ST_NAME,
-        ST_ARGS,
-        ST_SEP,
-        ST_END,
-    } state = ST_NAME;
+    static auto is_explicit(const Node &node) -> bool {
+        return is_defined(node) && tag_of(node) == "!";
+    }
 
-    int level = 0;
-    std::string_view arg;
+    static auto is_scalar(const Node &node) -> bool { return type(node) == YAML::NodeType::Scalar; }
 
-    for (auto it = type.cbegin(); it != type.cend(); ++it) {
-        MIROIR_ASSERT(state != ST_END, "invalid generic parser intermediate state: " << type);
+    static auto is_sequence(const Node &node) -> bool {
+        return type(node) == YAML::NodeType::Sequence;
+    }
 
-        const unsigned char c = *it;
+    static auto is_map(const Node &node) -> bool { return type(node) == YAML::NodeType::Map; }
 
-        if (std::isspace(c)) {
-            continue;
-        }
+    template <typename Key> static auto at(const Node &node, const Key &key) -> Node {
+        MIROIR_ASSERT(is_sequence(node) || is_map(node),
+                      "node is not a sequence or a map: " << dump(node));
 
-        if (c == m_settings.generic_brackets[0]) {
-            ++level;
+        const FlatDocument::NodeData &data = node.document->m_nodes[node.index];
+        const std::uint32_t *children = node.document->m_children.data() + data.begin;
 
-            if (level == 1) {
-                state = ST_ARGS;
-                continue; // skip open bracket
+        if constexpr (std::is_integral_v<Key>) {
+            if (is_sequence(node) && static_cast<std::size_t>(key) < data.size) {
+                return Node{.document = node.document, .index = children[key]};
             }
-        } else if (c == m_settings.generic_brackets[1]) {
-            --level;
+        } else {
+            for (std::uint32_t i = 0; is_map(node) && i < data.size; i += 2) {
+                const Node child_key{.document = node.document, .index = children[i]};
 
-            if (level == 0) {
-                state = ST_END;
+                if (is_scalar(child_key) && scalar_view(child_key) == key) {
+                    return Node{.document = node.document, .index = children[i + 1]};
+                }
             }
-        } else if (level == 1 && c == m_settings.generic_separator[0]) {
-            state = ST_SEP;
         }
 
-        switch (state) {
-        case ST_NAME:
-            generic_type.name += c;
-            break;
-        case ST_ARGS:
-            arg = std::string_view{!arg.empty() ? arg.cbegin() : &(*it), arg.size() + 1};
-            break;
-        case ST_SEP:
-            state = ST_ARGS;
-            [[fallthrough]];
-        case ST_END:
-            MIROIR_ASSERT(!arg.empty(), "generic arg is empty: " << type);
-            generic_type.args.push_back(std::string{arg});
-            arg = std::string_view{};
-            break;
-        default:
-            MIROIR_ASSERT(false, "invalid generic parser state: " << state);
-        }
+        return Node{.document = node.document, .index = UINT32_MAX};
     }
 
-    MIROIR_ASSERT(level == 0, "generic brackets are disbalanced: " << type);
-    MIROIR_ASSERT(state == ST_END, "invalid generic parser end state: " << type);
-    MIROIR_ASSERT(!generic_type.name.empty(), "generic name is empty: " << type);
-    MIROIR_ASSERT(!generic_type.args.empty(), "generic args are empty: " << type);
+    template <typename T> static auto as(const Node &node) -> T {
+        static_assert(std::is_same_v<T, std::string>, "flat nodes are converted to strings only");
 
-    m_generic_types_cache[type] = generic_type;
+        if (type(node) == YAML::NodeType::Null) {
+            return "null";
+        }
 
-    // todo: return reference to cache?
-    return generic_type;
-}
+        if (!is_scalar(node)) {
+            throw YAML::TypedBadConversion<std::string>(YAML::Mark::null_mark());
+        }
 
-template <typename Node>
-auto Validator<Node>::make_generic_args(const GenericType &keys, const GenericType &vals,
-                                        const std::map<std::string, std::string> &where) const
-    -> std::map<std::string, std::string> {
+        return std::string{scalar_view(node)};
+    }
 
-    MIROIR_ASSERT(!keys.args.empty(), "generic args are empty");
-    MIROIR_ASSERT(!vals.args.empty(), "generic args are empty");
-    MIROIR_ASSERT(keys.args.size() == vals.args.size(), "generic args count mismatch");
+    // conversions needed for the schema settings and types
+    template <typename T> static auto as(const Node &node, const T &fallback) -> T {
+        if constexpr (std::is_same_v<T, bool>) {
+            // same values as accepted by yaml-cpp
+            static const std::map<std::string_view, bool> values = {
+                {"y", true},      {"Y", true},      {"yes", true},    {"Yes", true},
+                {"YES", true},    {"true", true},   {"True", true},   {"TRUE", true},
+                {"on", true},     {"On", true},     {"ON", true},     {"n", false},
+                {"N", false},     {"no", false},    {"No", false},    {"NO", false},
+                {"false", false}, {"False", false}, {"FALSE", false}, {"off", false},
+                {"Off", false},   {"OFF", false},
+            };
+
+            const auto value_it = is_scalar(node) ? values.find(scalar_view(node)) : values.end();
+            return value_it != values.end() ? value_it->second : fallback;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return is_scalar(node) ? std::string{scalar_view(node)} : fallback;
+        } else {
+            static_assert(std::is_same_v<T, std::map<std::string, Node>>,
+                          "flat nodes are converted to bools, strings or maps only");
 
-    std::map<std::string, std::string> generic_args;
+            if (!is_map(node)) {
+                return fallback;
+            }
 
-    for (std::size_t i = 0; i < keys.args.size(); ++i) {
-        const std::string key = keys.args[i];
-        const std::string val = vals.args[i];
+            T map;
 
-        const auto it = where.find(val);
-        if (it == where.end()) {
-            generic_args[key] = val;
-        } else {
-            generic_args[key] = it->second;
+            for (auto it = begin(node); it != end(node); ++it) {
+                if (!is_scalar(it->first)) {
+                    return fallback;
+                }
+
+                map.emplace(scalar_view(it->first), it->second);
+            }
+
+            return map;
         }
     }
 
-    return generic_args;
-}
-
-} // namespace miroir
+    static auto scalar_view(const Node &node) -> std::string_view {
+        const FlatDocument::NodeData &data = node.document->m_nodes[node.index];
+        return std::string_view{node.document->m_strings}.substr(data.begin, data.size);
+    }
 
-#endif // ifdef MIROIR_IMPLEMENTATION
+    static auto tag(const Node &node) -> std::string { return tag_of(node).substr(1); }
 
-#ifdef MIROIR_YAMLCPP_SPECIALIZATION
+    static auto dump(const Node &node) -> std::string {
+        // rare, so the node is converted to the yaml-cpp one to be emitted the same way
+        std::map<std::uint32_t, YAML::Node> yaml_nodes;
+        return NodeAccessor<YAML::Node>::dump(to_yaml(node, yaml_nodes));
+    }
 
-#include <yaml-cpp/yaml.h>
+    static auto equals(const Node &lhs, const Node &rhs) -> bool {
+        if (is_same(lhs, rhs)) {
+            return true;
+        }
 
-namespace miroir {
+        const YAML::NodeType::value lhs_type = type(lhs);
 
-template <> struct NodeAccessor<YAML::Node> {
-    using Node = YAML::Node;
-    using Iterator = YAML::const_iterator;
+        if (lhs_type != type(rhs) || emitted_tag(lhs) != emitted_tag(rhs)) {
+            return false;
+        }
 
-    static auto is_defined(const Node &node) -> bool { return node.IsDefined(); }
+        switch (lhs_type) {
+        case YAML::NodeType::Scalar:
+            return scalar_view(lhs) == scalar_view(rhs);
+        case YAML::NodeType::Sequence:
+        case YAML::NodeType::Map:
+            return size(lhs) == size(rhs) &&
+                   std::equal(begin(lhs), end(lhs), begin(rhs),
+                              [](const FlatIteratorValue &lhs_child,
+                                 const FlatIteratorValue &rhs_child) -> bool {
+                                  return equals(lhs_child, rhs_child) &&
+                                         equals(lhs_child.first, rhs_child.first) &&
+                                         equals(lhs_child.second, rhs_child.second);
+                              });
+        case YAML::NodeType::Null:
+        case YAML::NodeType::Undefined:
+            return true;
+        }
 
-    static auto is_explicit(const Node &node) -> bool {
-        // see: https://yaml.org/spec/1.2.2/#24-tags
-        // Explicit typing is denoted with a tag using the exclamation point (“!”) symbol.
-        return node.Tag() == "!";
+        return false;
     }
 
-    static auto is_scalar(const Node &node) -> bool { return node.IsScalar(); }
-    static auto is_sequence(const Node &node) -> bool { return node.IsSequence(); }
-    static auto is_map(const Node &node) -> bool { return node.IsMap(); }
-
-    template <typename Key> static auto at(const Node &node, const Key &key) -> Node {
-        MIROIR_ASSERT(node.IsSequence() || node.IsMap(),
-                      "node is not a sequence or a map: " << dump(node));
-        return node[key];
+    static auto is_same(const Node &lhs, const Node &rhs) -> bool {
+        return lhs.document == rhs.document && lhs.index == rhs.index;
     }
 
-    template <typename T> static auto as(const Node &node) -> T { return node.as<T>(); }
-
-    template <typename T> static auto as(const Node &node, const T &fallback) -> T {
-        return node.as<T, T>(fallback);
+    static auto identity(const Node &node) -> const void * {
+        // aliases reference the same node
+        return is_defined(node) ? &node.document->m_nodes[node.index] : nullptr;
     }
 
-    static auto tag(const Node &node) -> std::string { return node.Tag().substr(1); }
+    static auto hash(const Node &node) -> std::size_t {
+        using YamlAccessor = NodeAccessor<YAML::Node>;
+        std::size_t seed = std::hash<std::string_view>{}(emitted_tag(node));
+
+        switch (type(node)) {
+        case YAML::NodeType::Null:
+            return YamlAccessor::hash_combine(seed, std::hash<std::string_view>{}("~"));
+        case YAML::NodeType::Scalar:
+            return YamlAccessor::hash_combine(seed,
+                                              std::hash<std::string_view>{}(scalar_view(node)));
+        case YAML::NodeType::Sequence:
+        case YAML::NodeType::Map:
+            seed = YamlAccessor::hash_combine(seed, type(node));
+
+            for (const std::uint32_t child : children(node)) {
+                seed = YamlAccessor::hash_combine(
+                    seed, hash(Node{.document = node.document, .index = child}));
+            }
 
-    static auto dump(const Node &node) -> std::string {
-        YAML::Emitter emitter;
-        emitter.SetSeqFormat(YAML::Flow);
-        emitter.SetMapFormat(YAML::Flow);
-        emitter << node;
-        MIROIR_ASSERT(emitter.good(), "invalid node to emit");
-        return emitter.c_str();
-    }
+            return seed;
+        case YAML::NodeType::Undefined:
+            return seed;
+        }
 
-    static auto equals(const Node &lhs, const Node &rhs) -> bool {
-        return lhs == rhs || dump(lhs) == dump(rhs);
+        return seed;
     }
 
-    static auto is_same(const Node &lhs, const Node &rhs) -> bool { return lhs == rhs; }
-
     static auto size(const Node &node) -> std::size_t {
-        MIROIR_ASSERT(node.IsSequence() || node.IsMap(),
+        MIROIR_ASSERT(is_sequence(node) || is_map(node),
                       "node is not a sequence or a map: " << dump(node));
-        return node.size();
+        const std::size_t child_count = node.document->m_nodes[node.index].size;
+        return is_map(node) ? child_count / 2 : child_count;
     }
 
     static auto begin(const Node &node) -> Iterator {
-        MIROIR_ASSERT(node.IsSequence() || node.IsMap(),
+        MIROIR_ASSERT(is_sequence(node) || is_map(node),
                       "node is not a sequence or a map: " << dump(node));
-        return node.begin();
+        return Iterator{node.document, node.document->m_nodes[node.index].begin, is_map(node)};
     }
 
     static auto end(const Node &node) -> Iterator {
-        MIROIR_ASSERT(node.IsSequence() || node.IsMap(),
+        MIROIR_ASSERT(is_sequence(node) || is_map(node),
                       "node is not a sequence or a map: " << dump(node));
-        return node.end();
+        const FlatDocument::NodeData &data = node.document->m_nodes[node.index];
+        return Iterator{node.document, std::size_t{data.begin} + data.size, is_map(node)};
+    }
+
+  private:
+    static auto type(const Node &node) -> YAML::NodeType::value {
+        return is_defined(node) ? static_cast<YAML::NodeType::value>(
+                                      node.document->m_nodes[node.index].type)
+                                : YAML::NodeType::Undefined;
+    }
+
+    static auto tag_of(const Node &node) -> const std::string & {
+        return node.document->m_tags[node.document->m_nodes[node.index].tag];
+    }
+
+    // returns tag of the node as it's emitted to the dump, empty if the tag is omitted
+    static auto emitted_tag(const Node &node) -> std::string_view {
+        if (!is_defined(node)) {
+            return {};
+        }
+
+        const std::string &tag = tag_of(node);
+        return tag == "?" || tag == "!" ? std::string_view{} : std::string_view{tag};
+    }
+
+    static auto children(const Node &node) -> std::span<const std::uint32_t> {
+        const FlatDocument::NodeData &data = node.document->m_nodes[node.index];
+        return std::span<const std::uint32_t>{node.document->m_children}.subspan(data.begin,
+                                                                                  data.size);
+    }
+
+    // nodes are converted once, so the aliases are emitted the same way as by yaml-cpp
+    static auto to_yaml(const Node &node, std::map<std::uint32_t, YAML::Node> &yaml_nodes)
+        -> YAML::Node {
+
+        if (!is_defined(node)) {
+            return YAML::Node{};
+        }
+
+        if (const auto yaml_node_it = yaml_nodes.find(node.index);
+            yaml_node_it != yaml_nodes.end()) {
+            return yaml_node_it->second;
+        }
+
+        YAML::Node yaml_node{type(node)};
+
+        if (is_scalar(node)) {
+            yaml_node = std::string{scalar_view(node)};
+        } else if (is_sequence(node)) {
+            for (auto it = begin(node); it != end(node); ++it) {
+                yaml_node.push_back(to_yaml(*it, yaml_nodes));
+            }
+        } else if (is_map(node)) {
+            for (auto it = begin(node); it != end(node); ++it) {
+                yaml_node.force_insert(to_yaml(it->first, yaml_nodes),
+                                       to_yaml(it->second, yaml_nodes));
+            }
+        }
+
+        if (type(node) != YAML::NodeType::Null) {
+            yaml_node.SetTag(tag_of(node));
+        }
+
+        yaml_nodes.emplace(node.index, yaml_node);
+        return yaml_node;
     }
 };
 
@@ -5,8 +5,16 @@
 #include <doctest/doctest.h>
 #include <yaml-cpp/yaml.h>
 
+#include "miroir_test_schema.hpp"
+
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 /// Misc
@@ -85,12 +93,23 @@ TEST_CASE("numeric type validation") {
         CHECK(errors.empty());
     }
 
+    SUBCASE("number formats are valid") {
+        validate("root: [numeric]", "[ +42, -42, .5, 5., -.5, 1e5, 1E-5, 99999999999999999999 ]");
+    }
+
     SUBCASE("string value is invalid") {
         const YAML::Node doc = YAML::Load("some string");
         const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
         CHECK(errors.size() == 1);
         CHECK(errors[0].description() == "/: expected value type: numeric");
     }
+
+    SUBCASE("number-like values are invalid") {
+        const YAML::Node doc = YAML::Load("[ inf, nan, 0x1A, 1e, 1.5.3, +-1, '1 ', 1e999 ]");
+        const std::vector<miroir::Error<YAML::Node>> errors =
+            miroir::Validator<YAML::Node>{YAML::Load("root: [numeric]")}.validate(doc);
+        CHECK(errors.size() == 8);
+    }
 }
 
 TEST_CASE("integer type validation") {
@@ -380,6 +399,30 @@ TEST_CASE("value variant validation") {
         CHECK(errors.empty());
     }
 
+    SUBCASE("quoted value '42' is valid") {
+        const YAML::Node doc = YAML::Load("'42'");
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.empty());
+    }
+
+    SUBCASE("map with reordered keys is invalid") {
+        const YAML::Node doc = YAML::Load("{ value: value, key: key }");
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.size() == 1);
+    }
+
+    SUBCASE("nested sequence is invalid") {
+        const YAML::Node doc = YAML::Load("[ 1, [ 2, 3 ] ]");
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.size() == 1);
+    }
+
+    SUBCASE("tagged value '42' is invalid") {
+        const YAML::Node doc = YAML::Load("!!str 42");
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.size() == 1);
+    }
+
     SUBCASE("value '420' is invalid") {
         const YAML::Node doc = YAML::Load("420");
         const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
@@ -392,6 +435,89 @@ TEST_CASE("value variant validation") {
     }
 }
 
+TEST_CASE("wide value variant validation") {
+    std::string schema_str = "root: !variant [ ~";
+
+    for (int i = 0; i < 1000; ++i) {
+        schema_str += ", code" + std::to_string(i);
+    }
+
+    schema_str += ", { key: [ 1, 2 ] } ]";
+
+    const YAML::Node schema = YAML::Load(schema_str);
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    SUBCASE("listed values are valid") {
+        for (const char *value : {"code0", "code500", "'code999'", "~", "{ key: [ 1, 2 ] }"}) {
+            CAPTURE(value);
+            const YAML::Node doc = YAML::Load(value);
+            const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+            CHECK(errors.empty());
+        }
+    }
+
+    SUBCASE("other values are invalid") {
+        for (const char *value : {"code1000", "'~'", "{ key: [ 2, 1 ] }", "[ code0 ]"}) {
+            CAPTURE(value);
+            const YAML::Node doc = YAML::Load(value);
+            const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+            CHECK(errors.size() == 1);
+        }
+    }
+}
+
+static std::atomic<int> counted_size_calls = 0;
+
+TEST_CASE("discriminated type variant validation") {
+    const std::map<std::string, miroir::Validator<YAML::Node>::TypeValidator> type_validators{
+        {"counted_size",
+         [](const YAML::Node &node) -> bool {
+             ++counted_size_calls;
+             return node.IsScalar();
+         }},
+    };
+
+    const YAML::Node schema = YAML::Load(R"(
+    settings:
+      ignore_attributes: true
+    types:
+      circle: { kind: !variant [circle], size: counted_size }
+      square: { kind: !variant [square], size: counted_size }
+    root: [[circle, square]]
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema, type_validators};
+
+    SUBCASE("variants with other kind are skipped") {
+        const YAML::Node doc = YAML::Load(R"(
+        - { kind: square, size: 1 }
+        - { kind:ATTR: square, size: 2 }
+        - { kind: circle, size: 3 }
+        )");
+
+        counted_size_calls = 0;
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.empty());
+        CHECK(counted_size_calls == 3);
+    }
+
+    SUBCASE("errors of skipped variants are reported") {
+        const YAML::Node doc = YAML::Load("[ { kind: triangle, size: 1 } ]");
+
+        counted_size_calls = 0;
+        CHECK(!validator.is_valid(doc));
+        CHECK(counted_size_calls == 0);
+
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.size() == 1);
+        CHECK(errors[0].description() == "/0: expected value type: [[circle, square]]"
+                                         "\n\t* failed variant 0:"
+                                         "\n\t\t/0.kind: expected value: circle"
+                                         "\n\t* failed variant 1:"
+                                         "\n\t\t/0.kind: expected value: square");
+    }
+}
+
 TEST_CASE("key value variant validation") {
     const YAML::Node schema = YAML::Load(R"(
     types:
@@ -531,6 +657,49 @@ TEST_CASE("nested errors") {
     }
 }
 
+/// Recursive types
+
+TEST_CASE("recursive type validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      tree<T>:
+        value: T
+        children: !optional [tree<T>]
+    root: tree<integer>
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    SUBCASE("tree is valid") {
+        const YAML::Node doc = YAML::Load(R"(
+        value: 1
+        children:
+          - value: 2
+          - value: 3
+            children:
+              - value: 4
+        )");
+
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.empty());
+    }
+
+    SUBCASE("deeply nested value is invalid") {
+        const YAML::Node doc = YAML::Load(R"(
+        value: 1
+        children:
+          - value: 2
+            children:
+              - value: some string
+        )");
+
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.size() == 1);
+        CHECK(errors[0].description() ==
+              "/children.0.children.0.value: expected value type: integer");
+    }
+}
+
 /// Structure
 
 TEST_CASE("required structure validation") {
@@ -704,6 +873,32 @@ TEST_CASE("key type validation") {
     }
 }
 
+TEST_CASE("overlapping key types validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    root:
+      $integer: integer
+      $numeric: string
+      $string: boolean
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    SUBCASE("keys are matched with the first key type") {
+        const YAML::Node doc = YAML::Load("{ 1: 2, 2.5: value, key: true }");
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.empty());
+    }
+
+    SUBCASE("errors are grouped by key types") {
+        const YAML::Node doc = YAML::Load("{ other: 5, 1: x, 2.5: value, 3: 4, 4: y }");
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.size() == 3);
+        CHECK(errors[0].description() == "/1: expected value type: integer");
+        CHECK(errors[1].description() == "/4: expected value type: integer");
+        CHECK(errors[2].description() == "/other: expected value type: boolean");
+    }
+}
+
 TEST_CASE("embedded key type validation") {
     const YAML::Node schema = YAML::Load(R"(
     types:
@@ -744,6 +939,71 @@ TEST_CASE("embedded key type validation") {
     }
 }
 
+TEST_CASE("nested embedded structure validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      base:
+        id: integer
+      named:
+        _: !embed base
+        name: string
+    root:
+      _: !embed named
+      child:
+        value: integer
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    SUBCASE("structure is valid") {
+        const YAML::Node doc = YAML::Load("{ id: 1, name: some name, child: { value: 2 } }");
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.empty());
+    }
+
+    SUBCASE("undefined nodes") {
+        const YAML::Node doc =
+            YAML::Load("{ id: 1, name: some name, child: { value: 2, extra: 3 }, extra: 4 }");
+
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.size() == 2);
+        CHECK(errors[0].description() == "/child.extra: undefined node");
+        CHECK(errors[1].description() == "/extra: undefined node");
+    }
+}
+
+TEST_CASE("undefined nodes of embedded structure validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      base:
+        id: integer
+    root:
+      _: !embed base
+      child:
+        _: !embed base
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    std::string doc_str = "id: 1\nchild:\n  id: 2\n";
+    for (int i = 0; i < 3000; ++i) {
+        doc_str += "  child_key" + std::to_string(i) + ": 1\n";
+    }
+    for (int i = 0; i < 3000; ++i) {
+        doc_str += "key" + std::to_string(i) + ": 1\n";
+    }
+
+    const YAML::Node doc = YAML::Load(doc_str);
+    const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+    REQUIRE(errors.size() == 6000);
+
+    for (int i = 0; i < 3000; ++i) {
+        CHECK(errors[i].description() ==
+              "/child.child_key" + std::to_string(i) + ": undefined node");
+        CHECK(errors[3000 + i].description() == "/key" + std::to_string(i) + ": undefined node");
+    }
+}
+
 /// Schema settings
 
 TEST_CASE("schema settings with default_required = false") {
@@ -978,6 +1238,49 @@ TEST_CASE("passed generic args validation") {
     }
 }
 
+TEST_CASE("nested passed generic args validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      one_of<T;Y>: [T, Y]
+      list<T>: [one_of<T;string>]
+    root:
+      integers: list<integer>
+      booleans: list<boolean>
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    SUBCASE("generic type accept values of the passed type and string values") {
+        const YAML::Node doc = YAML::Load(R"(
+        integers: [ 42, some string ]
+        booleans: [ true, some string ]
+        )");
+
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.empty());
+    }
+
+    SUBCASE("each instance of generic type has its own args") {
+        const YAML::Node doc = YAML::Load(R"(
+        integers: [ true ]
+        booleans: [ 42 ]
+        )");
+
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc);
+        CHECK(errors.size() == 2);
+        CHECK(errors[0].description() == "/integers.0: expected value type: one_of<T;string>"
+                                         "\n\t* failed variant 0:"
+                                         "\n\t\t/integers.0: expected value type: integer"
+                                         "\n\t* failed variant 1:"
+                                         "\n\t\t/integers.0: expected value type: string");
+        CHECK(errors[1].description() == "/booleans.0: expected value type: one_of<T;string>"
+                                         "\n\t* failed variant 0:"
+                                         "\n\t\t/booleans.0: expected value type: boolean"
+                                         "\n\t* failed variant 1:"
+                                         "\n\t\t/booleans.0: expected value type: string");
+    }
+}
+
 TEST_CASE("generic map validation") {
     const YAML::Node schema = YAML::Load(R"(
     types:
@@ -1055,5 +1358,1291 @@ TEST_CASE("'if' generic type validation") {
     }
 }
 
+/// Error limit
+
+TEST_CASE("error limit validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    root:
+      name: string
+      values: [integer]
+      variant: [integer, { first: integer, second: integer }]
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    const YAML::Node doc = YAML::Load(R"(
+    values: [1, x, 3, y, z]
+    variant: { first: x, second: y }
+    extra: true
+    )");
+
+    const std::vector<miroir::Error<YAML::Node>> all_errors = validator.validate(doc);
+    REQUIRE(all_errors.size() == 6);
+
+    SUBCASE("fail-fast") {
+        const std::vector<miroir::Error<YAML::Node>> errors =
+            validator.validate(doc, {.max_error_count = 1});
+
+        CHECK(errors.size() == 1);
+        CHECK(errors[0].description() == "/name: node not found");
+    }
+
+    SUBCASE("first errors are reported") {
+        const std::vector<miroir::Error<YAML::Node>> errors =
+            validator.validate(doc, {.max_error_count = 3});
+
+        REQUIRE(errors.size() == 3);
+        for (std::size_t i = 0; i < errors.size(); ++i) {
+            CHECK(errors[i].description() == all_errors[i].description());
+        }
+    }
+
+    SUBCASE("variant errors are limited") {
+        const YAML::Node variant_doc = YAML::Load("{ name: some name, values: [], variant: x }");
+
+        const std::vector<miroir::Error<YAML::Node>> errors =
+            validator.validate(variant_doc, {.max_error_count = 1});
+
+        REQUIRE(errors.size() == 1);
+        REQUIRE(errors[0].variant_errors.size() == 2);
+        CHECK(errors[0].variant_errors[0].size() == 1);
+        CHECK(errors[0].variant_errors[1].size() == 1);
+    }
+
+    SUBCASE("limit is larger than the number of errors") {
+        const std::vector<miroir::Error<YAML::Node>> errors =
+            validator.validate(doc, {.max_error_count = 100});
+
+        CHECK(errors.size() == all_errors.size());
+    }
+
+    SUBCASE("parallel validation") {
+        std::string doc_str = "name: some name\nvalues:\n";
+        for (int i = 0; i < 1000; ++i) {
+            doc_str += i % 3 == 0 ? "  - x\n" : "  - 1\n";
+        }
+
+        miroir::ThreadPool thread_pool{4};
+        const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(
+            YAML::Load(doc_str),
+            {.executor = &thread_pool, .parallel_threshold = 16, .max_error_count = 10});
+
+        CHECK(errors.size() == 10);
+    }
+}
+
+/// Validity check
+
+TEST_CASE("validity check") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      map<K;V>: { $K: V }
+      base:
+        id: integer
+      item:
+        _: !embed base
+        name: string
+      kind: !variant [first, second]
+      value: [integer, boolean]
+    root:
+      items: [item]
+      values: !optional map<string;value>
+      kind: !optional kind
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    const std::vector<std::string> docs = {
+        "items: [{ id: 1, name: first }, { id: 2, name: second }]",
+        "{ items: [], values: { a: 1, b: true }, kind: second }",
+        "items: [{ id: 1, name: first, extra: true }]",
+        "items: [{ id: x, name: first }]",
+        "items: [{ name: first }]",
+        "{ items: [], values: { a: x } }",
+        "{ items: [], kind: third }",
+        "{ items: [], unknown: 1 }",
+        "items: {}",
+    };
+
+    for (const std::string &doc_str : docs) {
+        CAPTURE(doc_str);
+
+        const YAML::Node doc = YAML::Load(doc_str);
+        CHECK(validator.is_valid(doc) == validator.validate(doc).empty());
+    }
+
+    CHECK(validator.is_valid(YAML::Load(docs[0])));
+    CHECK(validator.is_valid(YAML::Load(docs[1])));
+    CHECK_FALSE(validator.is_valid(YAML::Load(docs[2])));
+}
+
+/// Memoization
+
+static std::atomic<int> counted_integer_calls = 0;
+
+TEST_CASE("memoized validation") {
+    const std::map<std::string, miroir::Validator<YAML::Node>::TypeValidator> type_validators{
+        {"counted_integer",
+         [](const YAML::Node &node) -> bool {
+             ++counted_integer_calls;
+             return node.IsScalar() && std::all_of(node.Scalar().begin(), node.Scalar().end(),
+                                                   [](char c) -> bool { return std::isdigit(c); });
+         }},
+    };
+
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      item:
+        name: string
+        value: counted_integer
+    root:
+      items: [item]
+      named_items: { $string: item }
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema, type_validators};
+
+    const YAML::Node doc = YAML::Load(R"(
+    items:
+      - &valid { name: first, value: 1 }
+      - *valid
+      - &invalid { name: second, value: x }
+      - *invalid
+    named_items:
+      first: *valid
+      second: *invalid
+    )");
+
+    counted_integer_calls = 0;
+    const std::vector<miroir::Error<YAML::Node>> expected_errors = validator.validate(doc);
+    REQUIRE(expected_errors.size() == 3);
+    CHECK(counted_integer_calls == 6);
+
+    // valid item is validated once, invalid items are validated again to report errors
+    counted_integer_calls = 0;
+    const std::vector<miroir::Error<YAML::Node>> errors =
+        validator.validate(doc, {.memoize = true});
+    CHECK(counted_integer_calls == 4);
+
+    REQUIRE(errors.size() == expected_errors.size());
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        CHECK(errors[i].description() == expected_errors[i].description());
+    }
+
+    CHECK_FALSE(validator.is_valid(doc, {.memoize = true}));
+
+    const YAML::Node valid_doc = YAML::Load(R"(
+    items: [&item { name: first, value: 1 }, *item]
+    named_items: { first: *item }
+    )");
+
+    CHECK(validator.is_valid(valid_doc, {.memoize = true}));
+    CHECK(validator.validate(valid_doc, {.memoize = true}).empty());
+}
+
+/// Statistics
+
+// checks the counters of the document below, the time isn't checked
+static void check_stats(const miroir::ValidationStats &stats) {
+    CHECK(stats.node_count == 12);
+    CHECK(stats.variant_attempt_count == 2);
+    CHECK(stats.variant_reject_count == 0);
+    CHECK(stats.variant_skip_count == 1);
+    CHECK(stats.key_probe_count == 2);
+
+    REQUIRE(stats.types.size() == 5);
+    CHECK(stats.types.at("shape").dispatch_count == 2);
+    CHECK(stats.types.at("circle").dispatch_count == 1);
+    CHECK(stats.types.at("square").dispatch_count == 1);
+    CHECK(stats.types.at("integer").dispatch_count == 4);
+    CHECK(stats.types.at("string").dispatch_count == 2);
+}
+
+TEST_CASE("validation stats") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      shape: [circle, square]
+      circle: { kind: !variant [circle], radius: integer }
+      square: { kind: !variant [square], size: integer }
+    root:
+      shapes: [shape]
+      $string: integer
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    const std::string doc_str = R"(
+    shapes:
+      - { kind: square, size: 1 }
+      - { kind: circle, radius: 2 }
+    first: 1
+    second: 2
+    )";
+
+    const YAML::Node doc = YAML::Load(doc_str);
+
+    SUBCASE("validation") {
+        miroir::ValidationStats stats;
+        CHECK(validator.validate(doc, {.stats = &stats}).empty());
+        check_stats(stats);
+
+        // time of the type includes time of the nested types
+        CHECK(stats.types.at("shape").time >= stats.types.at("square").time);
+    }
+
+    SUBCASE("validity check") {
+        miroir::ValidationStats stats;
+        CHECK(validator.is_valid(doc, {.stats = &stats}));
+        check_stats(stats);
+    }
+
+    SUBCASE("parallel validation") {
+        miroir::ThreadPool thread_pool{4};
+        miroir::ValidationStats stats;
+        CHECK(validator.validate(doc, {.executor = &thread_pool, .parallel_threshold = 1,
+                                       .stats = &stats})
+                  .empty());
+        check_stats(stats);
+    }
+
+    SUBCASE("batch validation") {
+        miroir::ThreadPool thread_pool{4};
+        const std::vector<YAML::Node> docs(8, doc);
+        miroir::ValidationStats stats;
+        validator.validate_batch(docs, {.executor = &thread_pool, .stats = &stats});
+        CHECK(stats.node_count == 12 * docs.size());
+        CHECK(stats.types.at("integer").dispatch_count == 4 * docs.size());
+    }
+
+    SUBCASE("stream validation") {
+        miroir::ValidationStats stats;
+        std::istringstream input{doc_str};
+        const std::vector<std::vector<miroir::Error<YAML::Node>>> errors =
+            miroir::validate_stream(validator, input, {.stats = &stats});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].empty());
+        check_stats(stats);
+    }
+
+    SUBCASE("stats are added to the existing ones") {
+        miroir::ValidationStats stats;
+        validator.validate(doc, {.stats = &stats});
+        validator.validate(doc, {.stats = &stats});
+        CHECK(stats.node_count == 24);
+        CHECK(stats.types.at("shape").dispatch_count == 4);
+    }
+}
+
+/// Streaming
+
+// checks that the streamed document has the same errors as the loaded one
+static void check_stream_errors(const miroir::Validator<YAML::Node> &validator,
+                                const std::string &doc_str,
+                                const miroir::ValidationOptions &options = {}) {
+    std::istringstream input{doc_str};
+    const std::vector<std::vector<miroir::Error<YAML::Node>>> stream_errors =
+        miroir::validate_stream(validator, input, options);
+    const std::vector<miroir::Error<YAML::Node>> errors =
+        validator.validate(YAML::Load(doc_str), options);
+
+    REQUIRE(stream_errors.size() == 1);
+    REQUIRE(stream_errors[0].size() == errors.size());
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        CHECK(stream_errors[0][i].description() == errors[i].description());
+    }
+}
+
+TEST_CASE("stream validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      map<K;V>: { $K: V }
+      point: { x: integer, y: integer }
+      circle: { kind: !variant [circle], center: point, radius: numeric }
+      square: { kind: !variant [square], corner: point, side: numeric }
+      named:
+        name: string
+        description: !optional string
+      item:
+        <<: !embed named
+        shape: [circle, square]
+    root:
+      version: integer
+      color: !variant [red, green, blue]
+      points: [point]
+      items: [item]
+      labels: !optional map<string;string>
+      extra: !optional {}
+      $integer: !required [string]
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    SUBCASE("valid document") {
+        check_stream_errors(validator, R"(
+        version: 1
+        color: red
+        points: [ { x: 1, y: 2 }, { x: 3, y: 4 } ]
+        items:
+          - { name: first, shape: { kind: circle, center: { x: 0, y: 0 }, radius: 1.5 } }
+          - { name: second, shape: { kind: square, corner: { x: 1, y: 1 }, side: 2 } }
+        labels: { team: core }
+        extra: { any: [ nested, { value: 1 } ] }
+        42: [ a, b ]
+        )");
+    }
+
+    SUBCASE("invalid document") {
+        check_stream_errors(validator, R"(
+        color: purple
+        undefined: { nested: [ 1, 2 ] }
+        points: [ { x: 1 }, { x: 1, y: two, z: 3 }, 42 ]
+        items:
+          - { name: first, other: 1, shape: { kind: triangle } }
+          - { shape: [] }
+        labels: { team: [ core ] }
+        extra: []
+        version: [ 1 ]
+        another: 1
+        )");
+    }
+
+    SUBCASE("aliases and duplicated keys") {
+        check_stream_errors(validator, R"(
+        version: &version 1
+        version: 2
+        color: &color { not: color }
+        points: [ &point { x: 1, y: 2 }, *point, *version ]
+        items: []
+        1: [ *color ]
+        )");
+    }
+
+    SUBCASE("wide maps") {
+        std::string doc = "version: 1\ncolor: red\npoints: []\nitems: []\nlabels:\n";
+
+        for (std::size_t i = 0; i < 500; ++i) {
+            doc += "  label" + std::to_string(i) + (i % 7 == 0 ? ": [ invalid ]\n" : ": value\n");
+        }
+
+        for (std::size_t i = 0; i < 500; ++i) {
+            doc += std::to_string(i) + (i % 5 == 0 ? ": [ [ invalid ] ]\n" : ": [ value ]\n");
+            doc += i % 9 == 0 ? "undefined" + std::to_string(i) + ": 1\n" : "";
+        }
+
+        check_stream_errors(validator, doc);
+    }
+
+    SUBCASE("document of invalid type") {
+        check_stream_errors(validator, "[ 1, 2, 3 ]");
+        check_stream_errors(validator, "some string");
+    }
+}
+
+TEST_CASE("stream validation with attributes") {
+    const YAML::Node schema = YAML::Load(R"(
+    settings:
+      ignore_attributes: true
+    root:
+      key: string
+      value: !optional integer
+      $string: [integer]
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    check_stream_errors(validator, "{ key:ATTR: a, key: b }");
+    check_stream_errors(validator, "{ key:ATTR: a, key:OTHER: b }");
+    check_stream_errors(validator, "{ other: [ 1 ], key:ATTR: [ 1 ], value:ATTR: value }");
+    check_stream_errors(validator, "{ value: 1, value:ATTR: [ a ] }");
+}
+
+TEST_CASE("stream validation with memoization") {
+    // nodes are released after validation, so the next ones may reuse their identities
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      port: integer
+      item: { name: string, port: port }
+    root:
+      ports: [port]
+      items: [item]
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    const std::string doc = R"(
+    ports: [1, 2, x, y, 3, z]
+    items: [{ name: a, port: 1 }, { name: b, port: x }, { name: c, port: 2 }, { name: [d] }]
+    )";
+
+    check_stream_errors(validator, doc, {.memoize = true});
+}
+
+TEST_CASE("stream validation of few documents") {
+    const YAML::Node schema = YAML::Load("root: { name: string }");
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    std::istringstream input{"name: first\n---\nname: [ second ]\n---\nother: third\n"};
+    const std::vector<std::vector<miroir::Error<YAML::Node>>> errors =
+        miroir::validate_stream(validator, input, {.max_error_count = 1});
+
+    REQUIRE(errors.size() == 3);
+    CHECK(errors[0].empty());
+    REQUIRE(errors[1].size() == 1);
+    CHECK(errors[1][0].description() == "/name: expected value type: string");
+    // undefined children are reported as soon as their keys are read
+    REQUIRE(errors[2].size() == 1);
+    CHECK(errors[2][0].description() == "/other: undefined node");
+}
+
+/// Flat document
+
+// checks that the flat document has the same errors as the yaml-cpp one
+static void check_flat_errors(const std::string &schema_str, const std::string &doc_str,
+                              const miroir::ValidationOptions &options = {}) {
+    const miroir::FlatDocument flat_schema{schema_str};
+    const miroir::FlatDocument flat_doc{doc_str};
+    const miroir::Validator<miroir::FlatNode> flat_validator{flat_schema.root()};
+    const std::vector<miroir::Error<miroir::FlatNode>> flat_errors =
+        flat_validator.validate(flat_doc.root(), options);
+
+    const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+    const std::vector<miroir::Error<YAML::Node>> errors =
+        validator.validate(YAML::Load(doc_str), options);
+
+    REQUIRE(flat_errors.size() == errors.size());
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        CHECK(flat_errors[i].description() == errors[i].description());
+    }
+}
+
+TEST_CASE("flat document validation") {
+    const std::string schema = R"(
+    settings:
+      ignore_attributes: true
+      default_required: false
+    types:
+      map<K;V>: { $K: V }
+      point: { x: !required integer, y: !required integer }
+      named:
+        name: !required string
+      item:
+        <<: !embed named
+        shape: !required [point, [point], !variant [none, ~, { kind: empty }]]
+    root:
+      version: !required numeric
+      flag: boolean
+      items: [item]
+      labels: map<string;string>
+      raw: any
+      '$integer': [scalar]
+    )";
+
+    SUBCASE("valid document") {
+        check_flat_errors(schema, R"(
+        version: 1.5
+        flag: yes
+        items:
+          - { name: first, shape: { x: 1, y: 2 } }
+          - { name: second, shape: [ { x: 1, y: 2 } ] }
+          - { name: third, shape: ~ }
+          - { name: 'fourth', shape: { kind: empty } }
+        labels: { team: core }
+        raw: { any: [ thing ] }
+        1: [ a, 'b' ]
+        )");
+    }
+
+    SUBCASE("invalid document") {
+        check_flat_errors(schema, R"(
+        version: '1'
+        flag: maybe
+        items:
+          - { name: [ first ], other: 1, shape: { x: 1 } }
+          - { shape: [ 1 ], name:ATTR: second }
+          - { name: third, shape: { kind: other } }
+        labels: { team: [ core ] }
+        1: [ [ a ] ]
+        undefined: node
+        )");
+    }
+
+    SUBCASE("aliases") {
+        const std::string doc = R"(
+        version: 1
+        items:
+          - &invalid { name: first, shape: { x: one, y: 2 } }
+          - *invalid
+          - &valid { name: second, shape: { x: 1, y: 2 } }
+          - *valid
+        )";
+
+        check_flat_errors(schema, doc);
+        check_flat_errors(schema, doc, {.memoize = true});
+    }
+
+    SUBCASE("document of invalid type") {
+        check_flat_errors(schema, "[ 1, 2, 3 ]");
+        check_flat_errors(schema, "");
+    }
+}
+
+TEST_CASE("flat document with custom validators") {
+    const miroir::FlatDocument schema{"root: [even]"};
+    const miroir::Validator<miroir::FlatNode> validator{
+        schema.root(),
+        {{"even", [](const miroir::FlatNode &node) -> bool {
+              using NodeAccessor = miroir::NodeAccessor<miroir::FlatNode>;
+              return NodeAccessor::is_scalar(node) &&
+                     (NodeAccessor::as<std::string>(node).back() - '0') % 2 == 0;
+          }}}};
+
+    const miroir::FlatDocument doc{"[ 2, 3, 4 ]"};
+    const std::vector<miroir::Error<miroir::FlatNode>> errors = validator.validate(doc.root());
+    REQUIRE(errors.size() == 1);
+    CHECK(errors[0].description() == "/1: expected value type: even");
+}
+
+TEST_CASE("scalar view points to the node data") {
+    using YamlAccessor = miroir::NodeAccessor<YAML::Node>;
+    using FlatAccessor = miroir::NodeAccessor<miroir::FlatNode>;
+
+    const YAML::Node yaml_doc = YAML::Load("{ key: value }");
+    const YAML::Node yaml_value = yaml_doc["key"];
+    CHECK(YamlAccessor::scalar_view(yaml_value) == "value");
+    CHECK(YamlAccessor::scalar_view(yaml_value).data() == yaml_value.Scalar().data());
+
+    const miroir::FlatDocument flat_doc{"{ key: value }"};
+    const miroir::FlatNode flat_value = FlatAccessor::at(flat_doc.root(), "key");
+    CHECK(FlatAccessor::scalar_view(flat_value) == "value");
+    CHECK(FlatAccessor::scalar_view(flat_value).data() ==
+          FlatAccessor::scalar_view(FlatAccessor::at(flat_doc.root(), "key")).data());
+}
+
+/// Static schemas
+
+namespace static_schema {
+
+using namespace miroir::schema;
+
+using Circle = Type<"circle", Struct<Field<"kind", Values<"circle">>, Field<"radius", Integer>>>;
+using Square = Type<"square", Struct<Field<"kind", Values<"square">>, Field<"size", Integer>>>;
+using Shape = Type<"shape", OneOf<Circle, Square>>;
+using Named = Type<"named", Struct<Field<"name", String>>>;
+using Labels = Type<"labels", Struct<OptionalKeys<String, String>>>;
+
+using Root = Struct<Embed<Named>, Field<"version", Numeric>, Field<"mode", Values<"fast", "slow">>,
+                    Optional<"shapes", Seq<Shape>>, Optional<"labels", Labels>,
+                    Optional<"value", OneOf<Integer, Seq<String>>>, OptionalKeys<Integer, Boolean>>;
+
+struct Tree : Type<"tree", Struct<Field<"value", Integer>, Optional<"children", Seq<Tree>>>> {};
+
+static auto is_even(const YAML::Node &node) -> bool {
+    return node.IsScalar() && !node.Scalar().empty() && (node.Scalar().back() - '0') % 2 == 0;
+}
+
+using Evens = Seq<Custom<"even", is_even>>;
+
+} // namespace static_schema
+
+// checks that the static validator has the same errors as the runtime one with the schema string
+template <typename Schema>
+static void check_static_errors(const std::string &schema_str, const std::string &doc_str,
+                                std::size_t max_error_count = 0) {
+    const YAML::Node doc = YAML::Load(doc_str);
+    const miroir::StaticValidator<YAML::Node, Schema> static_validator;
+    const std::vector<miroir::Error<YAML::Node>> static_errors =
+        static_validator.validate(doc, max_error_count);
+
+    const miroir::Validator<YAML::Node> validator{YAML::Load(schema_str)};
+    const std::vector<miroir::Error<YAML::Node>> errors =
+        validator.validate(doc, {.max_error_count = max_error_count});
+
+    REQUIRE(static_errors.size() == errors.size());
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        CHECK(static_errors[i].description() == errors[i].description());
+    }
+
+    CHECK(static_validator.is_valid(doc) == errors.empty());
+}
+
+TEST_CASE("static schema validation") {
+    const std::string schema = R"(
+    types:
+      circle: { kind: !variant [circle], radius: integer }
+      square: { kind: !variant [square], size: integer }
+      shape: [circle, square]
+      named: { name: string }
+      labels: { $string: !optional string }
+    root:
+      _: !embed named
+      version: numeric
+      mode: !variant [fast, slow]
+      shapes: !optional [shape]
+      labels: !optional labels
+      value: !optional [integer, [string]]
+      $integer: !optional boolean
+    )";
+
+    const std::string invalid_doc = R"(
+    version: x
+    mode: medium
+    shapes: [{ kind: circle, size: 1 }, { kind: triangle }, 3]
+    labels: { a: [b] }
+    value: {}
+    1: 2
+    extra: 1
+    )";
+
+    SUBCASE("valid document") {
+        check_static_errors<static_schema::Root>(schema, R"(
+        name: doc
+        version: 1.5
+        mode: fast
+        shapes: [{ kind: circle, radius: 1 }, { kind: square, size: 2 }]
+        labels: { a: b }
+        value: [x, y]
+        1: yes
+        )");
+    }
+
+    SUBCASE("invalid document") { check_static_errors<static_schema::Root>(schema, invalid_doc); }
+
+    SUBCASE("not a map") { check_static_errors<static_schema::Root>(schema, "[1]"); }
+
+    SUBCASE("error limit") {
+        check_static_errors<static_schema::Root>(schema, invalid_doc, 2);
+    }
+
+    SUBCASE("flat document") {
+        const miroir::FlatDocument flat_doc{invalid_doc};
+        const std::vector<miroir::Error<miroir::FlatNode>> flat_errors =
+            miroir::StaticValidator<miroir::FlatNode, static_schema::Root>{}.validate(
+                flat_doc.root());
+        const std::vector<miroir::Error<YAML::Node>> errors =
+            miroir::StaticValidator<YAML::Node, static_schema::Root>{}.validate(
+                YAML::Load(invalid_doc));
+
+        REQUIRE(flat_errors.size() == errors.size());
+        for (std::size_t i = 0; i < errors.size(); ++i) {
+            CHECK(flat_errors[i].description() == errors[i].description());
+        }
+    }
+}
+
+TEST_CASE("static recursive type validation") {
+    const std::string schema = R"(
+    types:
+      tree: { value: integer, children: !optional [tree] }
+    root: tree
+    )";
+
+    check_static_errors<static_schema::Tree>(schema, R"(
+    value: 1
+    children: [{ value: 2, children: [{ value: 3 }] }]
+    )");
+
+    check_static_errors<static_schema::Tree>(schema, R"(
+    value: 1
+    children: [{ value: x }, { children: [{ value: 2, children: 3 }] }]
+    )");
+}
+
+TEST_CASE("static custom type validation") {
+    const miroir::StaticValidator<YAML::Node, static_schema::Evens> validator;
+    const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(YAML::Load("[2, 3]"));
+
+    REQUIRE(errors.size() == 1);
+    CHECK(errors[0].description() == "/1: expected value type: even");
+    CHECK(validator.is_valid(YAML::Load("[2, 4]")));
+}
+
+/// Generated validators
+
+// custom types of the generated test schema
+struct GeneratedCustom {
+    template <typename Node> static auto even(const Node &node) -> bool {
+        using NodeAccessor = miroir::NodeAccessor<Node>;
+        return NodeAccessor::is_scalar(node) &&
+               (NodeAccessor::template as<std::string>(node).back() - '0') % 2 == 0;
+    }
+};
+
+// returns the runtime validator of the generated test schema, it covers all kinds of the schema
+// nodes
+static auto generated_schema_validator() -> miroir::Validator<YAML::Node> {
+    return miroir::Validator<YAML::Node>{
+        YAML::Load(std::string{test_schema::Validator<YAML::Node>::schema}),
+        {{"even", GeneratedCustom::even<YAML::Node>}}};
+}
+
+// checks that the generated validator has the same errors as the runtime one with its schema
+template <typename Node>
+static void check_generated_errors(const Node &schema, const Node &doc,
+                                   std::size_t max_error_count = 0) {
+    using Generated = test_schema::Validator<Node, GeneratedCustom>;
+
+    const std::vector<miroir::Error<Node>> generated_errors =
+        Generated::validate(doc, max_error_count);
+
+    const miroir::Validator<Node> validator{schema, {{"even", GeneratedCustom::even<Node>}}};
+    const std::vector<miroir::Error<Node>> errors =
+        validator.validate(doc, {.max_error_count = max_error_count});
+
+    REQUIRE(generated_errors.size() == errors.size());
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        CHECK(generated_errors[i].description() == errors[i].description());
+    }
+
+    CHECK(Generated::is_valid(doc) == errors.empty());
+}
+
+static void check_generated_errors(const std::string &doc_str, std::size_t max_error_count = 0) {
+    using Generated = test_schema::Validator<YAML::Node>;
+
+    check_generated_errors(YAML::Load(std::string{Generated::schema}), YAML::Load(doc_str),
+                           max_error_count);
+
+    const miroir::FlatDocument flat_schema{std::string{Generated::schema}};
+    const miroir::FlatDocument flat_doc{doc_str};
+    check_generated_errors(flat_schema.root(), flat_doc.root(), max_error_count);
+}
+
+TEST_CASE("generated validator") {
+    const std::string invalid_doc = R"(
+    version: x
+    mode: medium
+    flag: maybe
+    shapes:
+      - { kind: circle, size: 1 }
+      - { kind: triangle }
+      - [{ kind: square, size: 2 }, none, { kind: other }]
+      - 3
+    labels: { a: [b] }
+    tree: { value: 2, children: [{ value: 3 }, { children: 4 }] }
+    value: x
+    items: {}
+    1: [[a]]
+    other: { name: [x] }
+    )";
+
+    SUBCASE("valid document") {
+        check_generated_errors(R"(
+        name: doc
+        version: 1.5
+        mode: quoted "mode"
+        flag: yes
+        shapes:
+          - { kind: circle, radius: 1 }
+          - { kind:ATTR: square, size: 2 }
+          - [none, ~, { kind: empty }, [{ kind: circle, radius: 3 }]]
+        labels: { a: b }
+        tree: { value: 2, children: [{ value: 4 }, { value: 6, children: [] }] }
+        value: [x, y]
+        raw: { any: [thing] }
+        items: [1, [2]]
+        1: [a, 'b']
+        other: { name: x }
+        )");
+    }
+
+    SUBCASE("invalid document") { check_generated_errors(invalid_doc); }
+
+    SUBCASE("not a map") {
+        check_generated_errors("[1]");
+        check_generated_errors("");
+    }
+
+    SUBCASE("error limit") { check_generated_errors(invalid_doc, 2); }
+}
+
+/// Binary schema
+
+// checks that the validator deserialized from the blob has the same errors as the original one
+template <typename Node>
+static void check_deserialized_errors(const miroir::Validator<YAML::Node> &validator,
+                                      const std::string &blob, const std::string &doc_str) {
+    const std::optional<miroir::Validator<Node>> deserialized =
+        miroir::Validator<Node>::deserialize(blob, {{"even", GeneratedCustom::even<Node>}});
+    REQUIRE(deserialized.has_value());
+
+    const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(YAML::Load(doc_str));
+    std::vector<miroir::Error<Node>> deserialized_errors;
+
+    if constexpr (std::is_same_v<Node, YAML::Node>) {
+        deserialized_errors = deserialized->validate(YAML::Load(doc_str));
+        CHECK(deserialized->is_valid(YAML::Load(doc_str)) == errors.empty());
+    } else {
+        const miroir::FlatDocument flat_doc{doc_str};
+        deserialized_errors = deserialized->validate(flat_doc.root());
+        CHECK(deserialized->is_valid(flat_doc.root()) == errors.empty());
+    }
+
+    REQUIRE(deserialized_errors.size() == errors.size());
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        CHECK(deserialized_errors[i].description() == errors[i].description());
+    }
+}
+
+TEST_CASE("binary schema round trip") {
+    const miroir::Validator<YAML::Node> validator = generated_schema_validator();
+    const std::string blob = validator.serialize();
+
+    const std::string valid_doc = R"(
+    name: doc
+    version: 1.5
+    mode: quoted "mode"
+    shapes: [{ kind:ATTR: square, size: 2 }, [none, ~, { kind: empty }]]
+    labels: { a: b }
+    tree: { value: 2, children: [{ value: 4 }] }
+    value: [x, y]
+    1: [a, 'b']
+    other: { name: x }
+    )";
+
+    const std::string invalid_doc = R"(
+    version: x
+    mode: medium
+    shapes: [{ kind: circle, size: 1 }, { kind: triangle }, [{ kind: other }], 3]
+    labels: { a: [b] }
+    tree: { value: 2, children: [{ value: 3 }, { children: 4 }] }
+    items: {}
+    1: [[a]]
+    other: { name: [x] }
+    )";
+
+    SUBCASE("same errors") {
+        for (const std::string &doc : {valid_doc, invalid_doc, std::string{"[1]"}}) {
+            check_deserialized_errors<YAML::Node>(validator, blob, doc);
+            check_deserialized_errors<miroir::FlatNode>(validator, blob, doc);
+        }
+    }
+
+    SUBCASE("serialized again") {
+        const std::optional<miroir::Validator<YAML::Node>> deserialized =
+            miroir::Validator<YAML::Node>::deserialize(
+                blob, {{"even", GeneratedCustom::even<YAML::Node>}});
+        REQUIRE(deserialized.has_value());
+        CHECK(deserialized->serialize() == blob);
+    }
+
+    SUBCASE("corrupted blob") {
+        const auto deserialize = [](const std::string &data) -> bool {
+            return miroir::Validator<YAML::Node>::deserialize(
+                       data, {{"even", GeneratedCustom::even<YAML::Node>}})
+                .has_value();
+        };
+
+        CHECK_FALSE(deserialize(""));
+        CHECK_FALSE(deserialize("miroir"));
+
+        // truncated
+        for (std::size_t size = 0; size < blob.size(); size += 7) {
+            CHECK_FALSE(deserialize(blob.substr(0, size)));
+        }
+
+        // other version
+        std::string other_version = blob;
+        ++other_version[14];
+        CHECK_FALSE(deserialize(other_version));
+
+        // trailing data
+        CHECK_FALSE(deserialize(blob + "x"));
+
+        // invalid settings, strings are prefixed with the 64-bit little-endian length
+        const auto replace_string = [&](const std::string &from,
+                                        const std::string &to) -> std::string {
+            const auto encode = [](const std::string &str) -> std::string {
+                std::string data(8, '\0');
+                data[0] = static_cast<char>(str.size());
+                return data + str;
+            };
+
+            std::string corrupted = blob;
+            const std::size_t position = corrupted.find(encode(from));
+            REQUIRE(position != std::string::npos);
+            return corrupted.replace(position, 8 + from.size(), encode(to));
+        };
+
+        CHECK(deserialize(replace_string("optional", "opt")));
+        CHECK_FALSE(deserialize(replace_string("optional", "")));
+        CHECK_FALSE(deserialize(replace_string("variant", "")));
+        CHECK_FALSE(deserialize(replace_string("<>", "<")));
+        CHECK_FALSE(deserialize(replace_string(";", ";;")));
+        CHECK_FALSE(deserialize(replace_string(":", "")));
+    }
+
+    SUBCASE("missing custom type validator") {
+        CHECK_FALSE(miroir::Validator<YAML::Node>::deserialize(blob).has_value());
+    }
+}
+
+/// Revalidation
+
+// checks that the document validated again after the changes has the same errors as validated
+// from scratch
+static void check_revalidated_errors(const miroir::Validator<YAML::Node> &validator,
+                                     const std::string &doc_str, const std::string &changed_str,
+                                     const std::vector<std::string> &changed_paths,
+                                     const miroir::ValidationOptions &options = {}) {
+    const std::vector<miroir::Error<YAML::Node>> previous_errors =
+        validator.validate(YAML::Load(doc_str));
+
+    const YAML::Node changed_doc = YAML::Load(changed_str);
+    const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(changed_doc, options);
+    const std::vector<miroir::Error<YAML::Node>> revalidated_errors =
+        validator.revalidate(changed_doc, previous_errors, changed_paths, options);
+
+    REQUIRE(revalidated_errors.size() == errors.size());
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        CHECK(revalidated_errors[i].description() == errors[i].description());
+    }
+}
+
+TEST_CASE("incremental revalidation") {
+    const miroir::Validator<YAML::Node> validator = generated_schema_validator();
+
+    const std::string doc = R"(
+    name: doc
+    version: 1.5
+    mode: fast
+    shapes: [{ kind: circle, radius: 1 }, { kind: square, size: x }, [none]]
+    labels: { a: b, c: [d] }
+    tree: { value: 2, children: [{ value: 3 }, { value: 4 }] }
+    1: [a]
+    { name: k }: { name: x }
+    )";
+
+    SUBCASE("unchanged") {
+        check_revalidated_errors(validator, doc, doc, {});
+    }
+
+    SUBCASE("fixed value") {
+        const std::string changed = R"(
+        name: doc
+        version: 1.5
+        mode: fast
+        shapes: [{ kind: circle, radius: 1 }, { kind: square, size: x }, [none]]
+        labels: { a: b, c: [d] }
+        tree: { value: 2, children: [{ value: 6 }, { value: 4 }] }
+        1: [a]
+        { name: k }: { name: x }
+        )";
+
+        check_revalidated_errors(validator, doc, changed, {"/tree.children.0.value"});
+    }
+
+    SUBCASE("invalid value") {
+        const std::string changed = R"(
+        name: doc
+        version: fast
+        mode: fast
+        shapes: [{ kind: circle, radius: 1 }, { kind: square, size: x }, [none]]
+        labels: { a: [b], c: [d] }
+        tree: { value: 2, children: [{ value: 3 }, { value: 4 }] }
+        1: [[a]]
+        { name: k }: { name: x }
+        )";
+
+        check_revalidated_errors(validator, doc, changed, {"/version", "/labels.a", "/1"});
+    }
+
+    SUBCASE("added and removed keys") {
+        const std::string changed = R"(
+        mode: fast
+        shapes: [{ kind: circle, radius: 1 }, { kind: square, size: x }, [none]]
+        labels: { a: b, c: [d], e: f }
+        tree: { value: 2, children: [{ value: 3 }, { value: 4 }], extra: 1 }
+        1: [a]
+        { name: k }: { name: x }
+        )";
+
+        check_revalidated_errors(validator, doc, changed,
+                                 {"/name", "/version", "/labels.e", "/tree.extra"});
+    }
+
+    SUBCASE("type variant") {
+        const std::string changed = R"(
+        name: doc
+        version: 1.5
+        mode: fast
+        shapes: [{ kind: circle, radius: 1 }, { kind: square, size: 2 }, [none, 1]]
+        labels: { a: b, c: [d] }
+        tree: { value: 2, children: [{ value: 3 }, { value: 4 }] }
+        1: [a]
+        { name: k }: { name: x }
+        )";
+
+        check_revalidated_errors(validator, doc, changed, {"/shapes.1.size", "/shapes.2.1"});
+    }
+
+    SUBCASE("removed sequence item") {
+        const std::string changed = R"(
+        name: doc
+        version: 1.5
+        mode: fast
+        shapes: [{ kind: square, size: x }, [none]]
+        labels: { a: b, c: [d] }
+        tree: { value: 2, children: [{ value: 3 }, { value: 4 }] }
+        1: [a]
+        { name: k }: { name: x }
+        )";
+
+        check_revalidated_errors(validator, doc, changed, {"/shapes"});
+    }
+
+    SUBCASE("changed key type child") {
+        const std::string changed = R"(
+        name: doc
+        version: 1.5
+        mode: fast
+        shapes: [{ kind: circle, radius: 1 }, { kind: square, size: x }, [none]]
+        labels: { a: b, c: [d] }
+        tree: { value: 2, children: [{ value: 3 }, { value: 4 }] }
+        1: [a]
+        other: { name: [x] }
+        )";
+
+        check_revalidated_errors(validator, doc, changed, {"/other.name"});
+    }
+
+    SUBCASE("changed root") {
+        check_revalidated_errors(validator, doc, "[1]", {"/"});
+    }
+
+    SUBCASE("error limit") {
+        const std::string changed = R"(
+        name: doc
+        version: 1.5
+        mode: slower
+        shapes: [{ kind: circle, radius: 1 }, { kind: square, size: x }, [none, 2]]
+        labels: { a: b, c: [d] }
+        tree: { value: 2, children: [{ value: 3 }, { value: 4 }] }
+        1: [a]
+        { name: k }: { name: x }
+        )";
+
+        for (std::size_t max_error_count = 1; max_error_count <= 4; ++max_error_count) {
+            check_revalidated_errors(validator, doc, changed, {"/mode", "/shapes.2"},
+                                     {.max_error_count = max_error_count});
+        }
+    }
+
+    SUBCASE("unchanged nodes are skipped") {
+        const std::vector<miroir::Error<YAML::Node>> previous_errors =
+            validator.validate(YAML::Load(doc));
+        REQUIRE_FALSE(previous_errors.empty());
+
+        // errors of the unchanged nodes are copied even if they are stale
+        const YAML::Node fixed_doc = YAML::Load(R"(
+        name: doc
+        version: 1.5
+        mode: fast
+        shapes: [{ kind: circle, radius: 1 }, { kind: square, size: 2 }, [none]]
+        labels: { a: b, c: d }
+        tree: { value: 2, children: [{ value: 4 }, { value: 4 }] }
+        1: [a]
+        { name: k }: { name: x }
+        )");
+        REQUIRE(validator.validate(fixed_doc).empty());
+
+        const std::vector<miroir::Error<YAML::Node>> errors =
+            validator.revalidate(fixed_doc, previous_errors, std::vector<std::string>{});
+
+        REQUIRE(errors.size() == previous_errors.size());
+        for (std::size_t i = 0; i < errors.size(); ++i) {
+            CHECK(errors[i].description() == previous_errors[i].description());
+        }
+    }
+}
+
+TEST_CASE("incremental revalidation of repeated paths") {
+    // the child is validated by the field and by the embedded field with the same path
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      base: { a: integer }
+      outer: { a: integer, b: integer, _: !embed base }
+    root: outer
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    check_revalidated_errors(validator, "{ a: x, b: 1 }", "{ a: x, b: y }", {"/b"});
+    check_revalidated_errors(validator, "{ a: x, b: y }", "{ a: x, b: 1 }", {"/b"});
+    check_revalidated_errors(validator, "{ a: x, b: 1 }", "{ a: 1, b: y }", {"/a", "/b"});
+}
+
+/// Concurrency
+
+TEST_CASE("concurrent validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      list<T>: [T]
+      map<K;V>: { $K: V }
+      one_of<T;Y>: [T, Y]
+      item:
+        name: string
+        tags: !optional list<one_of<integer;string>>
+        attributes: !optional map<string;boolean>
+    root: list<item>
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    const std::string valid_doc = R"(
+    - name: first
+      tags: [ 1, two, 3 ]
+    - name: second
+      attributes: { enabled: true, visible: false }
+    )";
+
+    const std::string invalid_doc = R"(
+    - name: first
+      tags: [ 1, [ two ], 3 ]
+    - attributes: { enabled: maybe }
+    )";
+
+    const std::vector<miroir::Error<YAML::Node>> expected_errors =
+        validator.validate(YAML::Load(invalid_doc));
+    REQUIRE(expected_errors.size() == 3);
+
+    constexpr int thread_count = 8;
+    constexpr int iteration_count = 50;
+
+    // note: documents are loaded per thread, only the validator is shared
+    std::vector<int> failure_counts(thread_count, 0);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i]() -> void {
+            const YAML::Node valid = YAML::Load(valid_doc);
+            const YAML::Node invalid = YAML::Load(invalid_doc);
+
+            for (int j = 0; j < iteration_count; ++j) {
+                if (!validator.validate(valid).empty()) {
+                    ++failure_counts[i];
+                }
+
+                const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(invalid);
+                const auto error_equals = [](const auto &lhs, const auto &rhs) -> bool {
+                    return lhs.description() == rhs.description();
+                };
+
+                if (!std::equal(errors.cbegin(), errors.cend(), expected_errors.cbegin(),
+                                expected_errors.cend(), error_equals)) {
+                    ++failure_counts[i];
+                }
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < thread_count; ++i) {
+        CHECK(failure_counts[i] == 0);
+    }
+}
+
+TEST_CASE("parallel validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      map<K;V>: { $K: V }
+      item:
+        name: string
+        value: !optional integer
+    root:
+      items: [item]
+      counters: map<string;integer>
+      matrix: [[integer]]
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    std::string doc_str = "items:\n";
+    for (int i = 0; i < 2000; ++i) {
+        doc_str += i % 97 == 0 ? "  - { value: " + std::to_string(i) + ", extra: true }\n"
+                               : "  - { name: item" + std::to_string(i) + " }\n";
+    }
+
+    doc_str += "counters:\n";
+    for (int i = 0; i < 2000; ++i) {
+        doc_str += "  counter" + std::to_string(i) + ": " + (i % 101 == 0 ? "none" : "42") + "\n";
+    }
+
+    doc_str += "matrix:\n";
+    for (int i = 0; i < 40; ++i) {
+        doc_str += "  - [";
+        for (int j = 0; j < 40; ++j) {
+            doc_str += (j > 0 ? ", " : "") + std::string{(i + j) % 37 == 0 ? "x" : "1"};
+        }
+        doc_str += "]\n";
+    }
+
+    const YAML::Node doc = YAML::Load(doc_str);
+    const std::vector<miroir::Error<YAML::Node>> expected_errors = validator.validate(doc);
+    REQUIRE(expected_errors.size() == 42 + 20 + 44);
+
+    miroir::ThreadPool thread_pool{4};
+    const miroir::ValidationOptions options{.executor = &thread_pool, .parallel_threshold = 16};
+    const std::vector<miroir::Error<YAML::Node>> errors = validator.validate(doc, options);
+
+    REQUIRE(errors.size() == expected_errors.size());
+
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        CHECK(errors[i].description() == expected_errors[i].description());
+    }
+}
+
+TEST_CASE("batch validation") {
+    const YAML::Node schema = YAML::Load(R"(
+    types:
+      map<K;V>: { $K: V }
+    root:
+      name: string
+      values: map<string;integer>
+    )");
+
+    const miroir::Validator<YAML::Node> validator{schema};
+
+    std::vector<YAML::Node> docs;
+    for (int i = 0; i < 100; ++i) {
+        docs.push_back(i % 3 == 0 ? YAML::Load("{ name: doc, values: { a: 1, b: x } }")
+                                  : YAML::Load("{ name: doc, values: { a: 1, b: 2 } }"));
+    }
+
+    const auto check_errors = [&](const auto &batch_errors) -> void {
+        REQUIRE(batch_errors.size() == docs.size());
+
+        for (std::size_t i = 0; i < docs.size(); ++i) {
+            if (i % 3 == 0) {
+                REQUIRE(batch_errors[i].size() == 1);
+                CHECK(batch_errors[i][0].description() ==
+                      "/values.b: expected value type: integer");
+            } else {
+                CHECK(batch_errors[i].empty());
+            }
+        }
+    };
+
+    SUBCASE("sequential batch validation") { check_errors(validator.validate_batch(docs)); }
+
+    SUBCASE("parallel batch validation") {
+        miroir::ThreadPool thread_pool{4};
+        check_errors(validator.validate_batch(docs, {.executor = &thread_pool}));
+    }
+}
+
+TEST_CASE("thread pool runs nested tasks") {
+    miroir::ThreadPool thread_pool{4};
+    std::atomic<int> task_count = 0;
+
+    thread_pool.run(8, [&](std::size_t) -> void {
+        thread_pool.run(8, [&](std::size_t) -> void { ++task_count; });
+    });
+
+    CHECK(task_count == 64);
+}
+
 // todo: test custom generic brackets and separator
 // todo: test custom attribute separator
@@ -0,0 +1,1104 @@
+// clang-format off
+// generated by miroir_codegen from tests/miroir_test_schema.yml, do not edit
+// note: must be included after <miroir/miroir.hpp> in the translation unit defining
+// MIROIR_IMPLEMENTATION
+
+#pragma once
+
+#ifndef MIROIR_IMPLEMENTATION
+#error "generated validator needs the miroir implementation"
+#endif
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace test_schema {
+
+// Custom provides the custom types as static functions, e.g.
+// `static auto even(const Node &node) -> bool`
+template <typename Node, typename Custom = void> class Validator {
+  public:
+    using Error = miroir::Error<Node>;
+
+  private:
+    using Runtime = miroir::GeneratedRuntime<Node>;
+    using NodeAccessor = typename Runtime::NodeAccessor;
+    using Expected = typename Runtime::Expected;
+    using Context = typename Runtime::Context;
+    using EmbedClaims = typename Runtime::EmbedClaims;
+    using MapChild = typename Runtime::MapChild;
+    using Field = typename Runtime::Field;
+    using ErrorType = miroir::ErrorType;
+
+  public:
+    // schema the validator is generated from
+    static constexpr std::string_view schema = R"miroir(# schema of the generated validator tests, regenerate with `make codegen`
+settings:
+  ignore_attributes: true
+types:
+  map<K;V>: { $K: V }
+  circle: { kind: !variant [circle], radius: integer }
+  square: { kind: !variant [square], size: integer }
+  shape: [circle, square, [shape], !variant [none, ~, { kind: empty }]]
+  named: { name: string }
+  tree: { value: even, children: !optional [tree] }
+root:
+  _: !embed named
+  version: numeric
+  mode: !variant [fast, slow, "quoted \"mode\""]
+  flag: !optional bool
+  shapes: !optional [shape]
+  labels: !optional map<string;string>
+  tree: !optional tree
+  value: !optional [integer, [string], {}]
+  raw: !optional any
+  items: !optional []
+  $integer: !optional [scalar]
+  $named: named
+)miroir";
+
+    // same as miroir::Validator::validate with ValidationOptions::max_error_count only
+    static auto validate(const Node &doc, std::size_t max_error_count = 0) -> std::vector<Error> {
+        static const Expected expected = Expected{std::string{"{_: !<!embed> named, version: numeric, mode: !<!variant> [fast, slow, quoted \"mode\"], flag: !<!optional> bool, shapes: !<!optional> [shape], labels: !<!optional> map<string;string>, tree: !<!optional> tree, value: !<!optional> [integer, [string], {}], raw: !<!optional> any, items: !<!optional> [], $integer: !<!optional> [scalar], $named: named}"}};
+        return Runtime::validate(doc, max_error_count, expected, &node_38);
+    }
+
+    // same as validate(doc).empty(), but doesn't build errors and stops on the first one
+    static auto is_valid(const Node &doc) -> bool {
+        static const Expected expected = Expected{std::string{"{_: !<!embed> named, version: numeric, mode: !<!variant> [fast, slow, quoted \"mode\"], flag: !<!optional> bool, shapes: !<!optional> [shape], labels: !<!optional> map<string;string>, tree: !<!optional> tree, value: !<!optional> [integer, [string], {}], raw: !<!optional> any, items: !<!optional> [], $integer: !<!optional> [scalar], $named: named}"}};
+        return Runtime::is_valid(doc, expected, &node_38);
+    }
+
+  private:
+    static void node_0(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"string"}};
+
+        if (!miroir::impl::node_is_string(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_1(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const std::string key_0{"name"};
+        static constexpr std::array<Field, 1> fields{{{"name", 0}}};
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_0), errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+        std::array<std::size_t, 1> field_children;
+        Runtime::find_fields(children, fields, ':', field_children);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_0);
+
+            if (field_children[0] != Runtime::npos) {
+                MapChild &child = children[field_children[0]];
+                node_0(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    static void node_2(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"named"}};
+        node_1(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_3(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"numeric"}};
+
+        if (!miroir::impl::node_is_number(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static constexpr std::array<std::string_view, 3> scalars_4{"fast", "quoted \"mode\"", "slow"};
+    static constexpr std::array<std::string_view, 0> dumps_4{};
+
+    static void node_4(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!Runtime::values_contain(doc, scalars_4, dumps_4)) {
+            Runtime::add_error(ErrorType::InvalidValue, ctx, errors);
+        }
+    }
+
+    static void node_5(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"bool"}};
+
+        if (!miroir::impl::node_is_boolean(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static constexpr std::array<std::string_view, 1> scalars_6{"circle"};
+    static constexpr std::array<std::string_view, 0> dumps_6{};
+
+    static void node_6(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!Runtime::values_contain(doc, scalars_6, dumps_6)) {
+            Runtime::add_error(ErrorType::InvalidValue, ctx, errors);
+        }
+    }
+
+    static void node_7(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"integer"}};
+
+        if (!miroir::impl::node_is_integer(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_8(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const std::string key_0{"kind"};
+        static const std::string key_1{"radius"};
+        static constexpr std::array<Field, 2> fields{{{"kind", 0}, {"radius", 1}}};
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_0), errors);
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_1), errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+        std::array<std::size_t, 2> field_children;
+        Runtime::find_fields(children, fields, ':', field_children);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_0);
+
+            if (field_children[0] != Runtime::npos) {
+                MapChild &child = children[field_children[0]];
+                node_6(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_1);
+
+            if (field_children[1] != Runtime::npos) {
+                MapChild &child = children[field_children[1]];
+                node_7(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    static void node_9(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"circle"}};
+        node_8(doc, ctx.with_expected(expected), errors);
+    }
+
+    static constexpr std::array<std::string_view, 1> scalars_10{"square"};
+    static constexpr std::array<std::string_view, 0> dumps_10{};
+
+    static void node_10(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!Runtime::values_contain(doc, scalars_10, dumps_10)) {
+            Runtime::add_error(ErrorType::InvalidValue, ctx, errors);
+        }
+    }
+
+    static void node_11(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"integer"}};
+
+        if (!miroir::impl::node_is_integer(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_12(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const std::string key_0{"kind"};
+        static const std::string key_1{"size"};
+        static constexpr std::array<Field, 2> fields{{{"kind", 0}, {"size", 1}}};
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_0), errors);
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_1), errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+        std::array<std::size_t, 2> field_children;
+        Runtime::find_fields(children, fields, ':', field_children);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_0);
+
+            if (field_children[0] != Runtime::npos) {
+                MapChild &child = children[field_children[0]];
+                node_10(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_1);
+
+            if (field_children[1] != Runtime::npos) {
+                MapChild &child = children[field_children[1]];
+                node_11(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    static void node_13(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"square"}};
+        node_12(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_14(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"shape"}};
+        node_17(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_15(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        const std::size_t size = NodeAccessor::size(doc);
+
+        for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {
+            node_14(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);
+        }
+    }
+
+    static constexpr std::array<std::string_view, 1> scalars_16{"none"};
+    static constexpr std::array<std::string_view, 2> dumps_16{"~", "{kind: empty}"};
+
+    static void node_16(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!Runtime::values_contain(doc, scalars_16, dumps_16)) {
+            Runtime::add_error(ErrorType::InvalidValue, ctx, errors);
+        }
+    }
+
+    // returns false if the node can't match the schema node
+    static auto shape_9(const Node &doc) -> bool {
+        if (!NodeAccessor::is_map(doc)) {
+            return false;
+        }
+
+        const std::optional<Node> value_0 = Runtime::find_value(doc, "kind", ':');
+
+        if (!value_0.has_value() || !Runtime::values_contain(*value_0, scalars_6, dumps_6)) {
+            return false;
+        }
+
+        const std::optional<Node> value_1 = Runtime::find_value(doc, "radius", ':');
+
+        if (!value_1.has_value()) {
+            return false;
+        }
+
+        return true;
+    }
+
+    // returns false if the node can't match the schema node
+    static auto shape_13(const Node &doc) -> bool {
+        if (!NodeAccessor::is_map(doc)) {
+            return false;
+        }
+
+        const std::optional<Node> value_0 = Runtime::find_value(doc, "kind", ':');
+
+        if (!value_0.has_value() || !Runtime::values_contain(*value_0, scalars_10, dumps_10)) {
+            return false;
+        }
+
+        const std::optional<Node> value_1 = Runtime::find_value(doc, "size", ':');
+
+        if (!value_1.has_value()) {
+            return false;
+        }
+
+        return true;
+    }
+
+    static void node_17(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        std::vector<std::vector<Error>> grouped_errors(4);
+        bool has_skipped_variants = false;
+
+        static const Expected expected_0 = Expected{std::string{"circle"}};
+
+        if (!shape_9(doc)) {
+            has_skipped_variants = true;
+        } else if (Runtime::validate_variant(doc, ctx, expected_0, &node_9, grouped_errors[0])) {
+            return;
+        }
+
+        static const Expected expected_1 = Expected{std::string{"square"}};
+
+        if (!shape_13(doc)) {
+            has_skipped_variants = true;
+        } else if (Runtime::validate_variant(doc, ctx, expected_1, &node_13, grouped_errors[1])) {
+            return;
+        }
+
+        static const Expected expected_2 = Expected{std::string{"[shape]"}};
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            has_skipped_variants = true;
+        } else if (Runtime::validate_variant(doc, ctx, expected_2, &node_15, grouped_errors[2])) {
+            return;
+        }
+
+        static const Expected expected_3 = Expected{std::string{"one of\n\t- none\n\t- ~\n\t- {kind: empty}"}};
+
+        if (Runtime::validate_variant(doc, ctx, expected_3, &node_16, grouped_errors[3])) {
+            return;
+        }
+
+        if (has_skipped_variants && !ctx.is_check_only) {
+            if (!shape_9(doc)) {
+                Runtime::validate_variant(doc, ctx, expected_0, &node_9, grouped_errors[0]);
+            }
+            if (!shape_13(doc)) {
+                Runtime::validate_variant(doc, ctx, expected_1, &node_13, grouped_errors[1]);
+            }
+            if (!NodeAccessor::is_sequence(doc)) {
+                Runtime::validate_variant(doc, ctx, expected_2, &node_15, grouped_errors[2]);
+            }
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        Runtime::add_error(ErrorType::InvalidValueType, ctx, errors, std::move(grouped_errors));
+    }
+
+    static void node_18(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"shape"}};
+        node_17(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_19(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        const std::size_t size = NodeAccessor::size(doc);
+
+        for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {
+            node_18(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);
+        }
+    }
+
+    static void node_20(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"string"}};
+
+        if (!miroir::impl::node_is_string(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_21(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            for (MapChild &child : children) {
+                if (child.is_validated) {
+                    continue;
+                }
+
+                if (miroir::impl::node_is_string(child.key)) {
+                    child.key_type = 0;
+                }
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            bool key_type_is_found = false;
+
+            for (std::size_t j = 0; j < children.size() && !ctx.is_stopped(); ++j) {
+                MapChild &child = children[j];
+
+                if (child.key_type == 0) {
+                    node_20(child.value, ctx.appending_key(child.key), errors);
+                    child.is_validated = true;
+                    key_type_is_found = true;
+                }
+            }
+
+            static const Expected key_type_expected = Expected{std::string{"K"}};
+
+            if (!key_type_is_found) {
+                Runtime::add_error(ErrorType::MissingKeyWithType, ctx.with_expected(key_type_expected), errors);
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    static void node_22(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"map<string;string>"}};
+        node_21(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_23(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"even"}};
+
+        if (!Custom::even(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_24(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"tree"}};
+        node_26(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_25(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        const std::size_t size = NodeAccessor::size(doc);
+
+        for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {
+            node_24(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);
+        }
+    }
+
+    static void node_26(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const std::string key_0{"value"};
+        static const std::string key_1{"children"};
+        static constexpr std::array<Field, 2> fields{{{"children", 1}, {"value", 0}}};
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_0), errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+        std::array<std::size_t, 2> field_children;
+        Runtime::find_fields(children, fields, ':', field_children);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+        static_cast<void>(embed_claims);
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_0);
+
+            if (field_children[0] != Runtime::npos) {
+                MapChild &child = children[field_children[0]];
+                node_23(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_1);
+
+            if (field_children[1] != Runtime::npos) {
+                MapChild &child = children[field_children[1]];
+                node_25(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+    static void node_27(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"tree"}};
+        node_26(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_28(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"integer"}};
+
+        if (!miroir::impl::node_is_integer(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_29(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"string"}};
+
+        if (!miroir::impl::node_is_string(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_30(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        const std::size_t size = NodeAccessor::size(doc);
+
+        for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {
+            node_29(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);
+        }
+    }
+
+    static void node_31(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+        }
+    }
+
+    // returns false if the node can't match the schema node
+    static auto shape_31(const Node &doc) -> bool {
+        if (!NodeAccessor::is_map(doc)) {
+            return false;
+        }
+
+        return true;
+    }
+
+    static void node_32(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        std::vector<std::vector<Error>> grouped_errors(3);
+        bool has_skipped_variants = false;
+
+        static const Expected expected_0 = Expected{std::string{"integer"}};
+
+        if (Runtime::validate_variant(doc, ctx, expected_0, &node_28, grouped_errors[0])) {
+            return;
+        }
+
+        static const Expected expected_1 = Expected{std::string{"[string]"}};
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            has_skipped_variants = true;
+        } else if (Runtime::validate_variant(doc, ctx, expected_1, &node_30, grouped_errors[1])) {
+            return;
+        }
+
+        static const Expected expected_2 = Expected{std::string{"{}"}};
+
+        if (!shape_31(doc)) {
+            has_skipped_variants = true;
+        } else if (Runtime::validate_variant(doc, ctx, expected_2, &node_31, grouped_errors[2])) {
+            return;
+        }
+
+        if (has_skipped_variants && !ctx.is_check_only) {
+            if (!NodeAccessor::is_sequence(doc)) {
+                Runtime::validate_variant(doc, ctx, expected_1, &node_30, grouped_errors[1]);
+            }
+            if (!shape_31(doc)) {
+                Runtime::validate_variant(doc, ctx, expected_2, &node_31, grouped_errors[2]);
+            }
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        Runtime::add_error(ErrorType::InvalidValueType, ctx, errors, std::move(grouped_errors));
+    }
+
+    static void node_33(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        // any node is valid
+        static_cast<void>(doc);
+        static_cast<void>(errors);
+    }
+
+    static void node_34(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+        }
+    }
+
+    static void node_35(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        static const Expected expected = Expected{std::string{"scalar"}};
+
+        if (!NodeAccessor::is_scalar(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx.with_expected(expected), errors);
+        }
+    }
+
+    static void node_36(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        if (ctx.embed_claims != nullptr) {
+            ctx.embed_claims->is_all = true;
+        }
+
+        if (!NodeAccessor::is_sequence(doc)) {
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        const std::size_t size = NodeAccessor::size(doc);
+
+        for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {
+            node_35(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);
+        }
+    }
+
+    static void node_37(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const Expected expected = Expected{std::string{"named"}};
+        node_1(doc, ctx.with_expected(expected), errors);
+    }
+
+    static void node_38(const Node &doc, const Context &ctx, std::vector<Error> &errors) {
+        if (ctx.is_stopped()) {
+            return;
+        }
+
+        static const std::string key_1{"version"};
+        static const std::string key_2{"mode"};
+        static const std::string key_3{"flag"};
+        static const std::string key_4{"shapes"};
+        static const std::string key_5{"labels"};
+        static const std::string key_6{"tree"};
+        static const std::string key_7{"value"};
+        static const std::string key_8{"raw"};
+        static const std::string key_9{"items"};
+        static constexpr std::array<Field, 9> fields{{{"flag", 3}, {"items", 9}, {"labels", 5}, {"mode", 2}, {"raw", 8}, {"shapes", 4}, {"tree", 6}, {"value", 7}, {"version", 1}}};
+
+        if (!NodeAccessor::is_map(doc)) {
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_1), errors);
+            Runtime::add_error(ErrorType::NodeNotFound, ctx.appending_path(key_2), errors);
+            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);
+            return;
+        }
+
+        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);
+        std::array<std::size_t, 10> field_children;
+        Runtime::find_fields(children, fields, ':', field_children);
+
+        EmbedClaims claims{.children = {}, .is_all = false};
+        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims : claims;
+
+        if (!ctx.is_stopped()) {
+            node_2(doc, ctx.with_embed(embed_claims), errors);
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_1);
+
+            if (field_children[1] != Runtime::npos) {
+                MapChild &child = children[field_children[1]];
+                node_3(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_2);
+
+            if (field_children[2] != Runtime::npos) {
+                MapChild &child = children[field_children[2]];
+                node_4(child.value, child_ctx, errors);
+                child.is_validated = true;
+            } else {
+                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, errors);
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_3);
+
+            if (field_children[3] != Runtime::npos) {
+                MapChild &child = children[field_children[3]];
+                node_5(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_4);
+
+            if (field_children[4] != Runtime::npos) {
+                MapChild &child = children[field_children[4]];
+                node_19(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_5);
+
+            if (field_children[5] != Runtime::npos) {
+                MapChild &child = children[field_children[5]];
+                node_22(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_6);
+
+            if (field_children[6] != Runtime::npos) {
+                MapChild &child = children[field_children[6]];
+                node_27(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_7);
+
+            if (field_children[7] != Runtime::npos) {
+                MapChild &child = children[field_children[7]];
+                node_32(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_8);
+
+            if (field_children[8] != Runtime::npos) {
+                MapChild &child = children[field_children[8]];
+                node_33(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            const Context child_ctx = ctx.appending_path(key_9);
+
+            if (field_children[9] != Runtime::npos) {
+                MapChild &child = children[field_children[9]];
+                node_34(child.value, child_ctx, errors);
+                child.is_validated = true;
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            for (MapChild &child : children) {
+                if (child.is_validated) {
+                    continue;
+                }
+
+                if (miroir::impl::node_is_integer(child.key)) {
+                    child.key_type = 0;
+                } else if (Runtime::validate_key(child.key, ctx, &node_1)) {
+                    child.key_type = 1;
+                }
+            }
+        }
+
+        if (!ctx.is_stopped()) {
+            bool key_type_is_found = false;
+
+            for (std::size_t j = 0; j < children.size() && !ctx.is_stopped(); ++j) {
+                MapChild &child = children[j];
+
+                if (child.key_type == 0) {
+                    node_36(child.value, ctx.appending_key(child.key), errors);
+                    child.is_validated = true;
+                    key_type_is_found = true;
+                }
+            }
+
+            static_cast<void>(key_type_is_found);
+        }
+
+        if (!ctx.is_stopped()) {
+            bool key_type_is_found = false;
+
+            for (std::size_t j = 0; j < children.size() && !ctx.is_stopped(); ++j) {
+                MapChild &child = children[j];
+
+                if (child.key_type == 1) {
+                    node_37(child.value, ctx.appending_key(child.key), errors);
+                    child.is_validated = true;
+                    key_type_is_found = true;
+                }
+            }
+
+            static const Expected key_type_expected = Expected{std::string{"named"}};
+
+            if (!key_type_is_found) {
+                Runtime::add_error(ErrorType::MissingKeyWithType, ctx.with_expected(key_type_expected), errors);
+            }
+        }
+
+        Runtime::finish_map(std::move(children), claims, ctx, errors);
+    }
+
+};
+
+} // namespace test_schema
@@ -0,0 +1,829 @@
+#define MIROIR_IMPLEMENTATION
+#define MIROIR_YAMLCPP_SPECIALIZATION
+#include <miroir/miroir.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace miroir {
+
+// emits the schema compiled by Validator as a class template with a function for each schema
+// node, the functions run on GeneratedRuntime, so the errors are the same as of the validator
+class CodeGenerator {
+  public:
+    using Validator = miroir::Validator<YAML::Node>;
+
+    // std::string source - schema file content
+    // std::set<std::string> custom_types - names of the types validated by the Custom class
+    CodeGenerator(const std::string &source, const std::set<std::string> &custom_types);
+
+    // std::string source_name - name of the schema file mentioned in the header comment
+    // std::string name_space - namespace of the generated validator
+    auto generate(const std::string &source_name, const std::string &name_space) const
+        -> std::string;
+
+  private:
+    using Schema = miroir::CompiledSchema<YAML::Node>;
+    using SchemaNode = Schema::SchemaNode;
+    using SchemaNodeKind = Schema::SchemaNodeKind;
+    using SchemaNodeId = Schema::SchemaNodeId;
+    using TypeId = Schema::TypeId;
+    using ShapeKind = Schema::ShapeKind;
+    using Shape = Schema::Shape;
+
+    static auto make_validators(const std::set<std::string> &custom_types)
+        -> std::map<std::string, Schema::TypeValidator>;
+
+    // returns the expected value as a C++ expression, rendered the same way as by dump_expected
+    static auto expected(const Schema::Expected &expected) -> std::string;
+
+    // returns condition of the built-in or custom type on the node, empty if any node is valid
+    auto type_condition(TypeId type_id, const std::string &node) const -> std::string;
+
+    void generate_node(SchemaNodeId node_id, std::ostringstream &out) const;
+    void generate_type(const SchemaNode &node, std::ostringstream &out) const;
+    void generate_sequence(SchemaNodeId node_id, const SchemaNode &node,
+                           std::ostringstream &out) const;
+    void generate_type_variant(const SchemaNode &node, std::ostringstream &out) const;
+    void generate_map(const SchemaNode &node, std::ostringstream &out) const;
+    void generate_values(SchemaNodeId node_id, const SchemaNode &node,
+                         std::ostringstream &out) const;
+    void generate_shape(SchemaNodeId node_id, const Shape &shape, std::ostringstream &out) const;
+
+    auto attribute_separator() const -> std::string;
+
+  private:
+    const std::string m_source;
+    const std::set<std::string> m_custom_types;
+    const Validator m_validator;
+};
+
+/// Strings
+
+// returns the string as a C++ string literal
+static auto quote(std::string_view str) -> std::string {
+    std::string result = "\"";
+
+    for (const char c : str) {
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (std::isprint(static_cast<unsigned char>(c))) {
+                result += c;
+            } else {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\%03o", static_cast<unsigned char>(c));
+                result += escaped;
+            }
+        }
+    }
+
+    return result + "\"";
+}
+
+static auto is_identifier(const std::string &str) -> bool {
+    return !str.empty() && !std::isdigit(static_cast<unsigned char>(str[0])) &&
+           std::all_of(str.begin(), str.end(), [](char c) -> bool {
+               return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+           });
+}
+
+/// CodeGenerator
+
+CodeGenerator::CodeGenerator(const std::string &source, const std::set<std::string> &custom_types)
+    : m_source{source}, m_custom_types{custom_types},
+      m_validator{YAML::Load(source), make_validators(custom_types)} {}
+
+auto CodeGenerator::make_validators(const std::set<std::string> &custom_types)
+    -> std::map<std::string, Schema::TypeValidator> {
+
+    // custom types are called by the generated code, so any validator is enough to compile
+    std::map<std::string, Schema::TypeValidator> validators;
+
+    for (const std::string &type : custom_types) {
+        validators.emplace(type, impl::node_is_any<YAML::Node>);
+    }
+
+    return validators;
+}
+
+auto CodeGenerator::generate(const std::string &source_name, const std::string &name_space) const
+    -> std::string {
+
+    std::ostringstream out;
+
+    out << "// clang-format off\n"
+           "// generated by miroir_codegen from "
+        << source_name
+        << ", do not edit\n"
+           "// note: must be included after <miroir/miroir.hpp> in the translation unit defining\n"
+           "// MIROIR_IMPLEMENTATION\n"
+           "\n"
+           "#pragma once\n"
+           "\n"
+           "#ifndef MIROIR_IMPLEMENTATION\n"
+           "#error \"generated validator needs the miroir implementation\"\n"
+           "#endif\n"
+           "\n"
+           "#include <array>\n"
+           "#include <optional>\n"
+           "#include <string>\n"
+           "#include <string_view>\n"
+           "#include <utility>\n"
+           "#include <vector>\n"
+           "\n"
+           "namespace "
+        << name_space
+        << " {\n"
+           "\n"
+           "// Custom provides the custom types as static functions, e.g.\n"
+           "// `static auto even(const Node &node) -> bool`\n"
+           "template <typename Node, typename Custom = void> class Validator {\n"
+           "  public:\n"
+           "    using Error = miroir::Error<Node>;\n"
+           "\n"
+           "  private:\n"
+           "    using Runtime = miroir::GeneratedRuntime<Node>;\n"
+           "    using NodeAccessor = typename Runtime::NodeAccessor;\n"
+           "    using Expected = typename Runtime::Expected;\n"
+           "    using Context = typename Runtime::Context;\n"
+           "    using EmbedClaims = typename Runtime::EmbedClaims;\n"
+           "    using MapChild = typename Runtime::MapChild;\n"
+           "    using Field = typename Runtime::Field;\n"
+           "    using ErrorType = miroir::ErrorType;\n"
+           "\n"
+           "  public:\n";
+
+    // the raw string can't be used if the schema contains its delimiter
+    if (m_source.find(")miroir\"") == std::string::npos) {
+        out << "    // schema the validator is generated from\n"
+               "    static constexpr std::string_view schema = R\"miroir("
+            << m_source << ")miroir\";\n\n";
+    } else {
+        out << "    // schema the validator is generated from\n"
+               "    static constexpr std::string_view schema = "
+            << quote(m_source) << ";\n\n";
+    }
+
+    out << "    // same as miroir::Validator::validate with ValidationOptions::max_error_count only\n"
+           "    static auto validate(const Node &doc, std::size_t max_error_count = 0) -> "
+           "std::vector<Error> {\n"
+           "        static const Expected expected = "
+        << expected(Schema::nodes(m_validator)[Schema::root(m_validator)].expected)
+        << ";\n"
+           "        return Runtime::validate(doc, max_error_count, expected, &node_"
+        << Schema::root(m_validator)
+        << ");\n"
+           "    }\n"
+           "\n"
+           "    // same as validate(doc).empty(), but doesn't build errors and stops on the first "
+           "one\n"
+           "    static auto is_valid(const Node &doc) -> bool {\n"
+           "        static const Expected expected = "
+        << expected(Schema::nodes(m_validator)[Schema::root(m_validator)].expected)
+        << ";\n"
+           "        return Runtime::is_valid(doc, expected, &node_"
+        << Schema::root(m_validator)
+        << ");\n"
+           "    }\n"
+           "\n"
+           "  private:\n";
+
+    for (SchemaNodeId node_id = 0; node_id < Schema::nodes(m_validator).size(); ++node_id) {
+        generate_node(node_id, out);
+    }
+
+    out << "};\n"
+           "\n"
+           "} // namespace "
+        << name_space << "\n";
+
+    return out.str();
+}
+
+auto CodeGenerator::expected(const Schema::Expected &expected) -> std::string {
+    return "Expected{std::string{" + quote(impl::dump_expected(expected)) + "}}";
+}
+
+auto CodeGenerator::type_condition(TypeId type_id, const std::string &node) const
+    -> std::string {
+
+    const std::string &name = Schema::types(m_validator)[type_id].name;
+
+    // custom types take precedence over the built-in ones, as in the Validator constructor
+    if (m_custom_types.contains(name)) {
+        return "Custom::" + name + "(" + node + ")";
+    }
+
+    static const std::map<std::string, std::string> builtin_conditions = {
+        {"any", ""},
+        {"map", "NodeAccessor::is_map"},
+        {"list", "NodeAccessor::is_sequence"},
+        {"scalar", "NodeAccessor::is_scalar"},
+        {"numeric", "miroir::impl::node_is_number"},
+        {"num", "miroir::impl::node_is_number"},
+        {"integer", "miroir::impl::node_is_integer"},
+        {"int", "miroir::impl::node_is_integer"},
+        {"boolean", "miroir::impl::node_is_boolean"},
+        {"bool", "miroir::impl::node_is_boolean"},
+        {"string", "miroir::impl::node_is_string"},
+        {"str", "miroir::impl::node_is_string"},
+    };
+
+    // `any` and the unnamed type of the null schema node take any node
+    const auto it = builtin_conditions.find(name);
+
+    if (it == builtin_conditions.end() || it->second.empty()) {
+        return "";
+    }
+
+    return it->second + "(" + node + ")";
+}
+
+void CodeGenerator::generate_node(SchemaNodeId node_id, std::ostringstream &out) const {
+    const SchemaNode &node = Schema::nodes(m_validator)[node_id];
+
+    if (node.kind == SchemaNodeKind::ValueVariant) {
+        generate_values(node_id, node, out);
+    }
+
+    if (node.kind == SchemaNodeKind::TypeVariant) {
+        for (std::size_t i = 0; i < node.children.size(); ++i) {
+            generate_shape(node.children[i], node.shapes[i], out);
+        }
+    }
+
+    out << "    static void node_" << node_id
+        << "(const Node &doc, const Context &ctx, std::vector<Error> &errors) {\n"
+           "        if (ctx.is_stopped()) {\n"
+           "            return;\n"
+           "        }\n"
+           "\n";
+
+    switch (node.kind) {
+    case SchemaNodeKind::Type:
+        generate_type(node, out);
+        break;
+    case SchemaNodeKind::AnySequence:
+    case SchemaNodeKind::Sequence:
+    case SchemaNodeKind::ValueVariant:
+        generate_sequence(node_id, node, out);
+        break;
+    case SchemaNodeKind::TypeVariant:
+        generate_type_variant(node, out);
+        break;
+    case SchemaNodeKind::AnyMap:
+    case SchemaNodeKind::Map:
+        generate_map(node, out);
+        break;
+    }
+
+    out << "    }\n\n";
+}
+
+void CodeGenerator::generate_type(const SchemaNode &node, std::ostringstream &out) const {
+    const Schema::Type &type = Schema::types(m_validator)[node.type];
+
+    // schema types
+    if (type.validator == nullptr) {
+        out << "        static const Expected expected = " << expected(node.expected)
+            << ";\n"
+               "        node_"
+            << type.node << "(doc, ctx.with_expected(expected), errors);\n";
+        return;
+    }
+
+    // built-in and custom types
+    out << "        if (ctx.embed_claims != nullptr) {\n"
+           "            ctx.embed_claims->is_all = true;\n"
+           "        }\n"
+           "\n";
+
+    const std::string condition = type_condition(node.type, "doc");
+
+    if (condition.empty()) {
+        out << "        // any node is valid\n"
+               "        static_cast<void>(doc);\n"
+               "        static_cast<void>(errors);\n";
+        return;
+    }
+
+    out << "        static const Expected expected = " << expected(node.expected)
+        << ";\n"
+           "\n"
+           "        if (!"
+        << condition
+        << ") {\n"
+           "            Runtime::add_error(ErrorType::InvalidValueType, "
+           "ctx.with_expected(expected), errors);\n"
+           "        }\n";
+}
+
+void CodeGenerator::generate_sequence(SchemaNodeId node_id, const SchemaNode &node,
+                                      std::ostringstream &out) const {
+
+    out << "        if (ctx.embed_claims != nullptr) {\n"
+           "            ctx.embed_claims->is_all = true;\n"
+           "        }\n"
+           "\n";
+
+    switch (node.kind) {
+    case SchemaNodeKind::AnySequence:
+        out << "        if (!NodeAccessor::is_sequence(doc)) {\n"
+               "            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);\n"
+               "        }\n";
+        break;
+    case SchemaNodeKind::ValueVariant:
+        out << "        if (!Runtime::values_contain(doc, scalars_" << node_id << ", dumps_"
+            << node_id
+            << ")) {\n"
+               "            Runtime::add_error(ErrorType::InvalidValue, ctx, errors);\n"
+               "        }\n";
+        break;
+    default:
+        out << "        if (!NodeAccessor::is_sequence(doc)) {\n"
+               "            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);\n"
+               "            return;\n"
+               "        }\n"
+               "\n"
+               "        const std::size_t size = NodeAccessor::size(doc);\n"
+               "\n"
+               "        for (std::size_t i = 0; i < size && !ctx.is_stopped(); ++i) {\n"
+               "            node_"
+            << node.children[0]
+            << "(NodeAccessor::at(doc, i), ctx.appending_index(i), errors);\n"
+               "        }\n";
+        break;
+    }
+}
+
+void CodeGenerator::generate_type_variant(const SchemaNode &node, std::ostringstream &out) const {
+
+    out << "        std::vector<std::vector<Error>> grouped_errors(" << node.children.size()
+        << ");\n"
+           "        bool has_skipped_variants = false;\n";
+
+    // returns condition of the variant shape, empty if the variant is always validated
+    const auto shape_condition = [&](std::size_t i) -> std::string {
+        switch (node.shapes[i].kind) {
+        case ShapeKind::Any:
+            return "";
+        case ShapeKind::Sequence:
+            return "NodeAccessor::is_sequence(doc)";
+        case ShapeKind::Map:
+            break;
+        }
+
+        return "shape_" + std::to_string(node.children[i]) + "(doc)";
+    };
+
+    for (std::size_t i = 0; i < node.children.size(); ++i) {
+        const SchemaNodeId child_id = node.children[i];
+        const std::string condition = shape_condition(i);
+        const std::string validate =
+            "Runtime::validate_variant(doc, ctx, expected_" + std::to_string(i) + ", &node_" +
+            std::to_string(child_id) + ", grouped_errors[" + std::to_string(i) + "])";
+
+        out << "\n        static const Expected expected_" << i << " = "
+            << expected(Schema::nodes(m_validator)[child_id].expected) << ";\n";
+
+        if (condition.empty()) {
+            out << "\n"
+                   "        if ("
+                << validate
+                << ") {\n"
+                   "            return;\n"
+                   "        }\n";
+        } else {
+            out << "\n"
+                   "        if (!"
+                << condition
+                << ") {\n"
+                   "            has_skipped_variants = true;\n"
+                   "        } else if ("
+                << validate
+                << ") {\n"
+                   "            return;\n"
+                   "        }\n";
+        }
+    }
+
+    out << "\n"
+           "        if (has_skipped_variants && !ctx.is_check_only) {\n";
+
+    for (std::size_t i = 0; i < node.children.size(); ++i) {
+        const std::string condition = shape_condition(i);
+
+        if (!condition.empty()) {
+            out << "            if (!" << condition
+                << ") {\n"
+                   "                Runtime::validate_variant(doc, ctx, expected_"
+                << i << ", &node_" << node.children[i] << ", grouped_errors[" << i
+                << "]);\n"
+                   "            }\n";
+        }
+    }
+
+    out << "        }\n"
+           "\n"
+           "        if (ctx.embed_claims != nullptr) {\n"
+           "            ctx.embed_claims->is_all = true;\n"
+           "        }\n"
+           "\n"
+           "        Runtime::add_error(ErrorType::InvalidValueType, ctx, errors, "
+           "std::move(grouped_errors));\n";
+}
+
+void CodeGenerator::generate_map(const SchemaNode &node, std::ostringstream &out) const {
+
+    if (node.kind == SchemaNodeKind::AnyMap) {
+        out << "        if (ctx.embed_claims != nullptr) {\n"
+               "            ctx.embed_claims->is_all = true;\n"
+               "        }\n"
+               "\n"
+               "        if (!NodeAccessor::is_map(doc)) {\n"
+               "            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);\n"
+               "        }\n";
+        return;
+    }
+
+    // keys of the fields for the paths and the sorted table of the fields
+    for (std::size_t i = 0; i < node.fields.size(); ++i) {
+        if (!node.fields[i].is_embed) {
+            out << "        static const std::string key_" << i << "{"
+                << quote(node.fields[i].key) << "};\n";
+        }
+    }
+
+    const bool has_fields = !node.field_indices.empty();
+
+    if (has_fields) {
+        out << "        static constexpr std::array<Field, " << node.field_indices.size()
+            << "> fields{{";
+
+        for (auto it = node.field_indices.begin(); it != node.field_indices.end(); ++it) {
+            out << (it == node.field_indices.begin() ? "" : ", ") << "{" << quote(it->first)
+                << ", " << it->second << "}";
+        }
+
+        out << "}};\n"
+               "\n";
+    }
+
+    out << "        if (!NodeAccessor::is_map(doc)) {\n";
+
+    for (std::size_t i = 0; i < node.fields.size(); ++i) {
+        if (!node.fields[i].is_embed && node.fields[i].is_required) {
+            out << "            Runtime::add_error(ErrorType::NodeNotFound, "
+                   "ctx.appending_path(key_"
+                << i << "), errors);\n";
+        }
+    }
+
+    if (!node.has_required_fields || !node.key_types.empty()) {
+        out << "            Runtime::add_error(ErrorType::InvalidValueType, ctx, errors);\n";
+    }
+
+    out << "            return;\n"
+           "        }\n"
+           "\n"
+           "        std::vector<MapChild> children = Runtime::begin_map(doc, ctx);\n";
+
+    if (has_fields) {
+        out << "        std::array<std::size_t, " << node.fields.size()
+            << "> field_children;\n"
+               "        Runtime::find_fields(children, fields, "
+            << attribute_separator() << ", field_children);\n";
+    }
+
+    out << "\n"
+           "        EmbedClaims claims{.children = {}, .is_all = false};\n"
+           "        EmbedClaims &embed_claims = ctx.embed_claims != nullptr ? *ctx.embed_claims "
+           ": claims;\n";
+
+    if (std::none_of(node.fields.begin(), node.fields.end(),
+                     [](const Schema::MapField &field) -> bool { return field.is_embed; })) {
+        out << "        static_cast<void>(embed_claims);\n";
+    }
+
+    for (std::size_t i = 0; i < node.fields.size(); ++i) {
+        const Schema::MapField &field = node.fields[i];
+
+        if (field.is_embed) {
+            out << "\n"
+                   "        if (!ctx.is_stopped()) {\n"
+                   "            node_"
+                << field.node
+                << "(doc, ctx.with_embed(embed_claims), errors);\n"
+                   "        }\n";
+            continue;
+        }
+
+        out << "\n"
+               "        if (!ctx.is_stopped()) {\n"
+               "            const Context child_ctx = ctx.appending_path(key_"
+            << i
+            << ");\n"
+               "\n"
+               "            if (field_children["
+            << i
+            << "] != Runtime::npos) {\n"
+               "                MapChild &child = children[field_children["
+            << i
+            << "]];\n"
+               "                node_"
+            << field.node
+            << "(child.value, child_ctx, errors);\n"
+               "                child.is_validated = true;\n"
+               "            }";
+
+        if (field.is_required) {
+            out << " else {\n"
+                   "                Runtime::add_error(ErrorType::NodeNotFound, child_ctx, "
+                   "errors);\n"
+                   "            }";
+        }
+
+        out << "\n"
+               "        }\n";
+    }
+
+    if (!node.key_types.empty()) {
+        // match keys of the children with key types, each key is matched once in the schema order
+        out << "\n"
+               "        if (!ctx.is_stopped()) {\n"
+               "            for (MapChild &child : children) {\n"
+               "                if (child.is_validated) {\n"
+               "                    continue;\n"
+               "                }\n"
+               "\n";
+
+        for (std::size_t i = 0; i < node.key_types.size(); ++i) {
+            const TypeId type_id = node.key_types[i].type;
+            const Schema::Type &type = Schema::types(m_validator)[type_id];
+            std::string condition = type.validator != nullptr
+                                        ? type_condition(type_id, "child.key")
+                                        : "Runtime::validate_key(child.key, ctx, &node_" +
+                                              std::to_string(type.node) + ")";
+
+            if (condition.empty()) {
+                condition = "true";
+            }
+
+            out << (i == 0 ? "                if (" : " else if (") << condition
+                << ") {\n"
+                   "                    child.key_type = "
+                << i << ";\n"
+                << "                }";
+        }
+
+        out << "\n"
+               "            }\n"
+               "        }\n";
+
+        for (std::size_t i = 0; i < node.key_types.size(); ++i) {
+            const Schema::MapKeyType &key_type = node.key_types[i];
+
+            out << "\n"
+                   "        if (!ctx.is_stopped()) {\n"
+                   "            bool key_type_is_found = false;\n"
+                   "\n"
+                   "            for (std::size_t j = 0; j < children.size() && !ctx.is_stopped(); "
+                   "++j) {\n"
+                   "                MapChild &child = children[j];\n"
+                   "\n"
+                   "                if (child.key_type == "
+                << i
+                << ") {\n"
+                   "                    node_"
+                << key_type.node
+                << "(child.value, ctx.appending_key(child.key), errors);\n"
+                   "                    child.is_validated = true;\n"
+                   "                    key_type_is_found = true;\n"
+                   "                }\n"
+                   "            }\n"
+                   "\n";
+
+            if (key_type.is_required) {
+                out << "            static const Expected key_type_expected = "
+                    << expected(key_type.name)
+                    << ";\n"
+                       "\n"
+                       "            if (!key_type_is_found) {\n"
+                       "                Runtime::add_error(ErrorType::MissingKeyWithType, "
+                       "ctx.with_expected(key_type_expected), errors);\n"
+                       "            }\n";
+            } else {
+                out << "            static_cast<void>(key_type_is_found);\n";
+            }
+
+            out << "        }\n";
+        }
+    }
+
+    out << "\n"
+           "        Runtime::finish_map(std::move(children), claims, ctx, errors);\n";
+}
+
+void CodeGenerator::generate_values(SchemaNodeId node_id, const SchemaNode &node,
+                                    std::ostringstream &out) const {
+
+    using NodeAccessor = NodeAccessor<YAML::Node>;
+
+    // plain and quoted scalars are looked up by the content, other values by the dump
+    std::vector<std::string> scalars;
+    std::vector<std::string> dumps;
+
+    for (const YAML::Node &value : node.values) {
+        if (NodeAccessor::is_scalar(value) && NodeAccessor::tag(value).empty()) {
+            scalars.push_back(value.Scalar());
+        } else {
+            dumps.push_back(NodeAccessor::dump(value));
+        }
+    }
+
+    std::sort(scalars.begin(), scalars.end());
+    scalars.erase(std::unique(scalars.begin(), scalars.end()), scalars.end());
+
+    const auto write_table = [&](const std::string &name,
+                                 const std::vector<std::string> &values) -> void {
+        out << "    static constexpr std::array<std::string_view, " << values.size() << "> "
+            << name << "_" << node_id << "{";
+
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            out << (i == 0 ? "" : ", ") << quote(values[i]);
+        }
+
+        out << "};\n";
+    };
+
+    write_table("scalars", scalars);
+    write_table("dumps", dumps);
+    out << "\n";
+}
+
+void CodeGenerator::generate_shape(SchemaNodeId node_id, const Shape &shape,
+                                   std::ostringstream &out) const {
+
+    if (shape.kind != ShapeKind::Map) {
+        return;
+    }
+
+    out << "    // returns false if the node can't match the schema node\n"
+           "    static auto shape_"
+        << node_id
+        << "(const Node &doc) -> bool {\n"
+           "        if (!NodeAccessor::is_map(doc)) {\n"
+           "            return false;\n"
+           "        }\n";
+
+    for (std::size_t i = 0; i < shape.fields.size(); ++i) {
+        const Schema::ShapeField &field = shape.fields[i];
+
+        out << "\n"
+               "        const std::optional<Node> value_"
+            << i << " = Runtime::find_value(doc, " << quote(field.key) << ", "
+            << attribute_separator()
+            << ");\n"
+               "\n"
+               "        if (!value_"
+            << i << ".has_value()";
+
+        if (field.values != Schema::npos) {
+            out << " || !Runtime::values_contain(*value_" << i << ", scalars_" << field.values
+                << ", dumps_" << field.values << ")";
+        }
+
+        out << ") {\n"
+               "            return false;\n"
+               "        }\n";
+    }
+
+    out << "\n"
+           "        return true;\n"
+           "    }\n"
+           "\n";
+}
+
+auto CodeGenerator::attribute_separator() const -> std::string {
+    if (!Schema::settings(m_validator).ignore_attributes) {
+        return "'\\0'";
+    }
+
+    return "'" + Schema::settings(m_validator).attribute_separator.substr(0, 1) + "'";
+}
+
+} // namespace miroir
+
+/// Main
+
+struct Options {
+    std::string name_space;
+    std::set<std::string> custom_types;
+    std::string input;
+    std::string output; // stdout if empty
+};
+
+static auto parse_options(int argc, char **argv) -> std::optional<Options> {
+    Options options{
+        .name_space = "schema",
+        .custom_types = {},
+        .input = "",
+        .output = "",
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const std::string value{arg.substr(std::min(arg.find('=') + 1, arg.size()))};
+
+        if (arg.starts_with("--namespace=") && !value.empty()) {
+            options.name_space = value;
+        } else if (arg.starts_with("--custom=") && miroir::is_identifier(value)) {
+            options.custom_types.insert(value);
+        } else if (arg.starts_with("--")) {
+            return std::nullopt;
+        } else if (options.input.empty()) {
+            options.input = arg;
+        } else if (options.output.empty()) {
+            options.output = arg;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    if (options.input.empty()) {
+        return std::nullopt;
+    }
+
+    return options;
+}
+
+auto main(int argc, char **argv) -> int {
+    const std::optional<Options> options = parse_options(argc, argv);
+
+    if (!options.has_value()) {
+        std::fprintf(stderr,
+                     "usage: %s [--namespace=<name>] [--custom=<type>]... <schema.yml> "
+                     "[<output.hpp>]\n",
+                     argv[0]);
+        return 1;
+    }
+
+    std::ifstream input{options->input};
+
+    if (!input) {
+        std::fprintf(stderr, "failed to read %s\n", options->input.c_str());
+        return 1;
+    }
+
+    const std::string source{std::istreambuf_iterator<char>{input},
+                             std::istreambuf_iterator<char>{}};
+
+    std::string code;
+
+    try {
+        const miroir::CodeGenerator generator{source, options->custom_types};
+        code = generator.generate(options->input, options->name_space);
+    } catch (const YAML::Exception &e) {
+        std::fprintf(stderr, "%s: %s\n", options->input.c_str(), e.what());
+        return 1;
+    }
+
+    if (options->output.empty()) {
+        std::fputs(code.c_str(), stdout);
+        return 0;
+    }
+
+    std::ofstream output{options->output};
+    output << code;
+
+    if (!output) {
+        std::fprintf(stderr, "failed to write %s\n", options->output.c_str());
+        return 1;
+    }
+
+    return 0;
+}